@@ -9,7 +9,7 @@
 #include <iostream>
 
 template<>
-void DayRunner<1>::solve(std::ifstream input) {
+void DayRunner<1>::solve(aoc::input_stream input) {
 	uint32_t increases = 0, sum_increases = 0;
 	uint32_t depth = 0;
 	uint32_t previous_depths[2] { 0 };
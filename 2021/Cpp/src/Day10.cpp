@@ -12,7 +12,7 @@
 #include <vector>
 
 template<>
-void DayRunner<10>::solve(std::ifstream input) {
+void DayRunner<10>::solve(aoc::input_stream input) {
 	std::string line;
 	std::stack<char> opened;
 	uint32_t error_score = 0;
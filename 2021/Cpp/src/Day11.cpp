@@ -13,7 +13,7 @@
 #include <vector>
 
 template<>
-void DayRunner<11>::solve(std::ifstream input) {
+void DayRunner<11>::solve(aoc::input_stream input) {
 	const uint8_t MAP_SIZE = 10;
 
 	uint8_t map[MAP_SIZE][MAP_SIZE];
@@ -14,7 +14,7 @@
 #include <vector>
 
 template<>
-void DayRunner<12>::solve(std::ifstream input) {
+void DayRunner<12>::solve(aoc::input_stream input) {
 	std::map<std::string, std::vector<std::string>> connections;
 	std::string line;
 	std::string first, second;
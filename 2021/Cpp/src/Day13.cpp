@@ -10,7 +10,7 @@
 #include <vector>
 
 template<>
-void DayRunner<13>::solve(std::ifstream input) {
+void DayRunner<13>::solve(aoc::input_stream input) {
 	std::vector<std::vector<bool>> map(2000);
 	std::vector<std::vector<bool>> new_map;
 	std::string line;
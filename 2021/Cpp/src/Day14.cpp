@@ -9,7 +9,7 @@
 #include <iostream>
 
 template<>
-void DayRunner<14>::solve(std::ifstream input) {
+void DayRunner<14>::solve(aoc::input_stream input) {
 	std::string line;
 	std::map<std::pair<char, char>, uint64_t> polymer;
 	std::map<std::pair<char, char>, char> insertions;
@@ -12,7 +12,7 @@
 #include <unordered_set>
 
 template<>
-void DayRunner<15>::solve(std::ifstream input) {
+void DayRunner<15>::solve(aoc::input_stream input) {
 	const uint8_t MAP_SIZE = 100;
 
 	std::string line;
@@ -12,7 +12,7 @@
 #include <vector>
 
 template<>
-void DayRunner<16>::solve(std::ifstream input) {
+void DayRunner<16>::solve(aoc::input_stream input) {
 	std::string line;
 	input >> line;
 	std::vector<bool> data(line.length() * 4);
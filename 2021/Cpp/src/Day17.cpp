@@ -6,35 +6,21 @@
  */
 
 #include "Main.h"
+#include "Parse.h"
 #include <cmath>
 #include <iostream>
 
 template<>
-void DayRunner<17>::solve(std::ifstream input) {
-	std::string line;
+void DayRunner<17>::solve(aoc::input_stream input) {
+	std::string_view text = input.view();
 	std::pair<int16_t, int16_t> target_x;
 	std::pair<int16_t, int16_t> target_y;
-	size_t dot_index;
-	int16_t start, end;
-	while (input >> line) {
-		dot_index = line.find('.');
-		if (dot_index != std::string::npos) {
-			start = std::stoi(line.substr(2, dot_index - 2));
-			dot_index += 2;
-			end = line.length() - dot_index;
-			if (line.find(',') != std::string::npos) {
-				end--;
-			}
-			end = std::stoi(line.substr(dot_index, end));
-		}
-
-		if (line[0] == 'x') {
-			target_x.first = start;
-			target_x.second = end;
-		} else if (line[0] == 'y') {
-			target_y.first = start;
-			target_y.second = end;
-		}
+	if (!aoc::parse::skip(text, "target area: x=")
+			|| !aoc::parse::pair(text, target_x, "..")
+			|| !aoc::parse::skip(text, ", y=")
+			|| !aoc::parse::pair(text, target_y, "..")) {
+		std::cerr << "Failed to parse the target area." << std::endl;
+		return;
 	}
 
 	int16_t vel_x, vel_y;
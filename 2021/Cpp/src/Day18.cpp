@@ -13,7 +13,7 @@
 #include <vector>
 
 template<>
-void DayRunner<18>::solve(std::ifstream input) {
+void DayRunner<18>::solve(aoc::input_stream input) {
 	std::string line;
 	std::string current;
 	std::vector<std::string> lines;
@@ -13,7 +13,7 @@
 #include <unordered_set>
 
 template<>
-void DayRunner<19>::solve(std::ifstream input) {
+void DayRunner<19>::solve(aoc::input_stream input) {
 	std::string line;
 	std::string token;
 	Position pos;
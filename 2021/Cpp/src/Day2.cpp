@@ -9,7 +9,7 @@
 #include <iostream>
 
 template<>
-void DayRunner<2>::solve(std::ifstream input) {
+void DayRunner<2>::solve(aoc::input_stream input) {
 	uint32_t depth = 0;
 	uint32_t horizontal = 0;
 	uint32_t aim = 0;
@@ -10,7 +10,7 @@
 #include <vector>
 
 template<>
-void DayRunner<20>::solve(std::ifstream input) {
+void DayRunner<20>::solve(aoc::input_stream input) {
 	std::string line;
 	input >> line;
 
@@ -11,7 +11,7 @@
 #include <stack>
 
 template<>
-void DayRunner<21>::solve(std::ifstream input) {
+void DayRunner<21>::solve(aoc::input_stream input) {
 	std::string line;
 
 	uint8_t player_1_start_pos = 0;
@@ -12,7 +12,7 @@
 #include <sstream>
 
 template<>
-void DayRunner<22>::solve(std::ifstream input) {
+void DayRunner<22>::solve(aoc::input_stream input) {
 	std::string line;
 	bool on = false;
 	int32_t coords[6];
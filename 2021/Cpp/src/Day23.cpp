@@ -13,7 +13,7 @@
 #include <unordered_set>
 
 template<>
-void DayRunner<23>::solve(std::ifstream input) {
+void DayRunner<23>::solve(aoc::input_stream input) {
 	const uint8_t burrow_count = 4;
 	const std::string part_2_burrows[burrow_count] = { "DD", "CB", "BA", "AC" };
 
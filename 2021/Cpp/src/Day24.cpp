@@ -6,22 +6,59 @@
  */
 
 #include "Day24.h"
+#include "Options.h"
+#include "Parse.h"
+#include "Phase.h"
 #include <algorithm>
+#include <chrono>
 #include <climits>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
 #include <sstream>
 #include <thread>
 #include <unordered_set>
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/mman.h>
+#define JIT_SUPPORTED
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CPUID_SUPPORTED
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define CPUID_SUPPORTED
+#endif
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
 
 enum ExecMode {
 	/**
 	 * Interprets the given input assembly.
 	 */
 	INTERPRETE,
+	/**
+	 * Pre-decodes the input assembly into a compact bytecode, and interprets that.
+	 * Also used if compiling the input assembly isn't possible.
+	 */
+	BYTECODE,
 	/**
 	 * Generates C code from the input assembly, compiles that, and runs it.
 	 */
-	COMPILE
+	COMPILE,
+	/**
+	 * Translates the input assembly to x86-64 machine code at runtime, and runs that.
+	 * Falls back to the bytecode interpreter on other platforms.
+	 */
+	JIT
 };
 
 enum RunType {
@@ -78,16 +115,32 @@ enum SIMDMode {
 	 */
 	SIMD_DISABLED,
 	/**
-	 * The generated C code will include SIMD intrinsics, even if they aren't available.
+	 * The solver for SIMD_TARGET will be used, even if the cpu doesn't support it.
 	 */
 	SIMD_ENABLED,
 	/**
-	 * The program automatically checks for the availability of SIMD intrinsics
-	 * and uses them if possible.
+	 * The program automatically checks which SIMD targets the cpu supports using cpuid,
+	 * and uses the widest one up to SIMD_TARGET.
 	 */
 	SIMD_AUTO
 };
 
+enum SearchMode {
+	/**
+	 * Checks every number, starting from the highest or lowest one.
+	 */
+	SEARCH_BRUTE_FORCE,
+	/**
+	 * Remembers states from which no valid number can be reached, and skips them when they are reached again.
+	 */
+	SEARCH_MEMOIZED,
+	/**
+	 * Uses memoization if at most two registers are live between input instructions, like in the MONAD program.
+	 * Otherwise states are unlikely to repeat, so brute force is used.
+	 */
+	SEARCH_AUTO
+};
+
 enum RegSize {
 	/**
 	 * The compiled solver will use 32 bit registers.
@@ -99,30 +152,108 @@ enum RegSize {
 	REG_SIZE_64
 };
 
+/*
+ * The settings below can be changed at runtime using "--option name=value",
+ * where name is the lower case name of the setting, like "--option exec_mode=bytecode".
+ */
+
+/**
+ * Whether the input assembly should be interpreted, compiled, or translated to machine code.
+ */
+ExecMode EXEC_MODE = JIT;
+
 /**
- * Whether the input assembly should be interpreted or compiled.
+ * The setting values of the ExecMode constants, indexed by their value.
  */
-const ExecMode EXEC_MODE = COMPILE;
+const std::array<std::string_view, 4> EXEC_MODE_NAMES { "interprete",
+		"bytecode", "compile", "jit" };
 
 /**
  * Whether the input assembly should be optimized.
  */
-const bool OPTIMIZE = true;
+bool OPTIMIZE = true;
+
+/**
+ * The setting values of boolean settings.
+ */
+const std::array<std::string_view, 2> BOOL_NAMES { "false", "true" };
+
+/**
+ * Whether to print the number of instructions after each optimization pass, and how long it took.
+ * Only applicable if OPTIMIZE is true.
+ */
+bool REPORT_PASSES = false;
+
+/**
+ * The maximum number of times optimize_instructions runs all OPTIMIZATION_PASSES.
+ * Usually they stop changing the program after two or three iterations.
+ * Can't be changed at runtime.
+ */
+const size_t MAX_OPTIMIZATION_ITERATIONS = 10;
+
+/**
+ * The passes run by optimize_instructions, in the order in which they are run.
+ * Static evaluation needs to be run before and after merging instructions.
+ */
+const OptimizationPass OPTIMIZATION_PASSES[] { { "static_eval", static_eval }, {
+		"merge_maths", merge_maths }, { "static_eval", static_eval }, {
+		"dead_code_removal", dead_code_removal },
+		{ "ssa_optimize", ssa_optimize } };
+
+/**
+ * The number of random inputs with which to compare the optimized program to the original one.
+ * 0 to not verify the optimized program.
+ * Only applicable if OPTIMIZE is true.
+ */
+size_t VERIFY_INPUTS = 0;
+
+/**
+ * The number of executions run_program_batch runs at once.
+ * Large enough for the loops over them to be vectorized efficiently,
+ * but small enough for the registers of all of them to fit into the L1 cache.
+ * Can't be changed at runtime.
+ */
+const size_t BATCH_BLOCK_SIZE = 512;
+
+/**
+ * The number of leading digits whose loops in the compiled solvers check whether they should stop.
+ * The loops of the later digits are too short for the check to matter.
+ * Can't be changed at runtime.
+ */
+const uint8_t STOP_CHECK_DIGITS = 8;
+
+/**
+ * The exclusive limit for the absolute value of a bound of a value range calculated by ssa_fold_ranges.
+ * Values that could reach it are treated as unknown, so calculating the ranges can't overflow.
+ * Can't be changed at runtime.
+ */
+const int64_t RANGE_LIMIT = 1ll << 62;
 
 /**
  * Whether the input program should be executed or solved.
  * Run type execute is not yet compatible with compiled execution.
  */
-const RunType RUN_TYPE = SOLVE;
+RunType RUN_TYPE = SOLVE;
+
+/**
+ * The setting values of the RunType constants, indexed by their value.
+ */
+const std::array<std::string_view, 2> RUN_TYPE_NAMES { "solve", "execute" };
 
 /**
  * The challenge part to solve.
  * Ignored in RUN_TYPE EXECUTE.
  */
-const SolvePart SOLVE_PART = BOTH;
+SolvePart SOLVE_PART = BOTH;
+
+/**
+ * The setting values of the SolvePart constants, indexed by their value.
+ */
+const std::array<std::string_view, 3> SOLVE_PART_NAMES { "1", "2", "both" };
 
 /**
  * The digits to use as input for the program.
+ * Can't be changed at runtime.
  */
 const char INPUT_DIGITS[] = { 10 };
 
@@ -131,31 +262,103 @@ const char INPUT_DIGITS[] = { 10 };
  * should be deleted after the execution finishes.
  * Only applicable with ExecType COMPILE.
  */
-const bool DELETE_COMPILATION_FILES = true;
+bool DELETE_COMPILATION_FILES = true;
 
 /**
  * When to print the current instructions to the standard output.
  * Multiple values can be combined using bitwise or.
+ * As a setting this is a comma separated list, like "initial,optimized".
  */
-const unsigned int PRINT_INSTRUCTIONS = NEVER;
+unsigned int PRINT_INSTRUCTIONS = NEVER;
+
+/**
+ * Whether the libraries and executables built by compile_instructions should be kept in CACHE_DIR,
+ * to be reused by later runs compiling the same code with the same compiler command.
+ * Only applicable with ExecType COMPILE.
+ */
+bool CACHE_COMPILATIONS = true;
+
+/**
+ * The directory in which to keep the cached libraries and executables.
+ * Can't be changed at runtime.
+ */
+const std::filesystem::path CACHE_DIR("cache");
 
 /**
  * Whether SIMD intrinsics should be used to improve the performance of the generated C code.
  * Only used with EXEC_MODE COMPILE and RUN_TYPE SOLVE.
- *
- * Currently only affects the block after the last input instruction.
  */
-const SIMDMode SIMD_MODE = SIMD_AUTO;
+SIMDMode SIMD_MODE = SIMD_AUTO;
+
+/**
+ * The setting values of the SIMDMode constants, indexed by their value.
+ */
+const std::array<std::string_view, 3> SIMD_MODE_NAMES { "disabled", "enabled",
+		"auto" };
+
+/**
+ * The widest SIMD target to generate a solver for.
+ * Solvers for all narrower targets are generated as well.
+ */
+SIMDTarget SIMD_TARGET = SIMD_AVX512;
+
+/**
+ * The setting values of the SIMDTarget constants, indexed by their value.
+ */
+const std::array<std::string_view, 3> SIMD_TARGET_NAMES { simdTargets[0].name,
+		simdTargets[1].name, simdTargets[2].name };
+
+/**
+ * Whether to compare the compiled solvers for all SIMD targets supported by the cpu after solving part 1.
+ * Only used with EXEC_MODE COMPILE.
+ */
+bool BENCHMARK_SIMD = false;
+
+/**
+ * How to search for the first valid number when solving the input.
+ * Doesn't affect the compiled solver.
+ */
+SearchMode SEARCH_MODE = SEARCH_AUTO;
+
+/**
+ * The setting values of the SearchMode constants, indexed by their value.
+ */
+const std::array<std::string_view, 3> SEARCH_MODE_NAMES { "brute_force",
+		"memoized", "auto" };
 
 /**
  * The register size to use for the compiled solver.
  * Does not have any effect in interpreted mode.
  * Works with both ExecModes.
  */
-const RegSize REGISTER_SIZE = REG_SIZE_32;
+RegSize REGISTER_SIZE = REG_SIZE_32;
+
+/**
+ * The setting values of the RegSize constants, indexed by their value.
+ */
+const std::array<std::string_view, 2> REGISTER_SIZE_NAMES { "32", "64" };
+
+/**
+ * Whether to compare all configurations using sweep_configurations, instead of solving the input normally.
+ * Only used with RUN_TYPE SOLVE.
+ */
+bool SWEEP = false;
+
+/**
+ * A single combination of settings compared by sweep_configurations.
+ */
+struct SweepConfig {
+	ExecMode exec_mode;
+	bool optimize;
+	SearchMode search_mode;
+	SIMDMode simd_mode;
+	RegSize register_size;
+};
 
 template<>
-void DayRunner<24>::solve(std::ifstream input) {
+void DayRunner<24>::solve(aoc::input_stream input) {
+	read_settings();
+
 	std::vector<Instruction> instructions;
 
 	std::string line;
@@ -244,87 +447,89 @@ void DayRunner<24>::solve(std::ifstream input) {
 		print_instructions("Initial", instructions, std::cout);
 	}
 
-	if (OPTIMIZE) {
-		instructions = static_eval(instructions);
-		if (PRINT_INSTRUCTIONS & STEP) {
-			print_instructions("Post static evaluation 1", instructions,
-					std::cout);
-		}
-		instructions = merge_maths(instructions);
-		if (PRINT_INSTRUCTIONS & STEP) {
-			print_instructions("Merged math and cmp instructions", instructions,
-					std::cout);
-		}
-		// Static evaluation needs to be run before and after merging instructions.
-		instructions = static_eval(instructions);
-		if (PRINT_INSTRUCTIONS & STEP) {
-			print_instructions("Post static evaluation 2", instructions,
-					std::cout);
-		}
-		instructions = dead_code_removal(instructions);
-		if (PRINT_INSTRUCTIONS & STEP) {
-			print_instructions("Post dead code removal", instructions,
-					std::cout);
-		}
-		instructions = delay_input(instructions);
-		if (PRINT_INSTRUCTIONS & STEP) {
-			print_instructions("Delayed input instructions", instructions,
-					std::cout);
-		}
-		if (PRINT_INSTRUCTIONS & OPTIMIZED) {
-			print_instructions("Fully optimized", instructions, std::cout);
+	if (RUN_TYPE == SOLVE && SWEEP) {
+		if (check_instructions(instructions)) {
+			sweep_configurations(instructions);
 		}
+		return;
 	}
 
-	for (size_t i = 0; i < instructions.size(); i++) {
-		const Instruction inst = instructions[i];
-		if (inst.type == InstType::DIV && inst.const_b && inst.in_b == 0) {
-			std::cerr << "Error: Instruction " << (i + 1) << '(' << inst
-					<< ") causes a division by zero." << std::endl;
+	if (OPTIMIZE) {
+		const std::vector<Instruction> original = instructions;
+		instructions = optimize_instructions(instructions);
+		if (VERIFY_INPUTS > 0
+				&& !verify_optimization(original, instructions, VERIFY_INPUTS)) {
 			return;
 		}
 	}
 
-	if (RUN_TYPE == SOLVE
-			&& std::count_if(instructions.begin(), instructions.end(),
-					[](const Instruction &inst) -> bool {
-						return inst.type == InstType::INP;
-					}) != 14) {
-		std::cerr << "The input did not contain 14 input instructions."
-				<< std::endl;
+	if (!check_instructions(instructions)) {
 		return;
 	}
 
 	std::filesystem::path tmpDir("tmp");
 	std::optional<std::filesystem::path> tmpExe = std::nullopt;
-	Compiler compiler = detect_compiler();
-	if (EXEC_MODE == COMPILE && compiler != Compiler::NONE) {
-		tmpExe = create_temp_lib(instructions, tmpDir, compiler);
-		if (!tmpExe.has_value()) {
-			std::cerr
-					<< "Creating compiled executable failed. Falling back to interpreter."
-					<< std::endl;
+	std::optional<CompiledSolver> solver = std::nullopt;
+	solverfunc solve_prefix = NULL;
+	if (EXEC_MODE == COMPILE) {
+		Compiler compiler = detect_compiler();
+		if (compiler != Compiler::NONE) {
+			tmpExe = create_temp_lib(instructions, tmpDir, compiler);
+			if (!tmpExe.has_value()) {
+				std::cerr
+						<< "Creating compiled executable failed. Falling back to bytecode interpreter."
+						<< std::endl;
+			} else if (RUN_TYPE == SOLVE) {
+				solver.emplace(tmpExe.value());
+				if (solver->is_valid()) {
+					solve_prefix = select_solver(solver.value());
+				}
+				if (!solve_prefix) {
+					std::cerr << "Falling back to bytecode interpreter."
+							<< std::endl;
+					solver.reset();
+				}
+			}
 		}
 	}
 
+	const bool use_jit = EXEC_MODE == JIT && jit_supported();
+	if (EXEC_MODE == JIT && !use_jit) {
+		std::cerr
+				<< "Runtime code generation isn't supported on this platform. Falling back to bytecode interpreter."
+				<< std::endl;
+	}
+
 	if (RUN_TYPE == SOLVE) {
 		int64_t part1 = -1;
 		if (SOLVE_PART == PART_1 || SOLVE_PART == BOTH) {
-			if (EXEC_MODE == COMPILE && tmpExe.has_value()) {
-				part1 = find_first_valid_compiled(tmpExe.value(), true);
-			} else {
+			if (solver.has_value()) {
+				part1 = find_first_valid_compiled(solve_prefix, true);
+			} else if (use_jit) {
+				part1 = find_first_valid_jit(instructions, true);
+			} else if (EXEC_MODE == INTERPRETE) {
 				part1 = find_first_valid_interpreted(instructions, true);
+			} else {
+				part1 = find_first_valid_bytecode(instructions, true);
 			}
 			std::cout << "The biggest valid serial number is " << part1 << '.'
 					<< std::endl;
+
+			if (BENCHMARK_SIMD && solver.has_value() && part1 != -1) {
+				benchmark_simd_targets(solver.value(), part1, true);
+			}
 		}
 
 		if (SOLVE_PART == PART_2 || SOLVE_PART == BOTH) {
 			int64_t part2 = -1;
-			if (EXEC_MODE == COMPILE && tmpExe.has_value()) {
-				part2 = find_first_valid_compiled(tmpExe.value(), false);
-			} else {
+			if (solver.has_value()) {
+				part2 = find_first_valid_compiled(solve_prefix, false);
+			} else if (use_jit) {
+				part2 = find_first_valid_jit(instructions, false);
+			} else if (EXEC_MODE == INTERPRETE) {
 				part2 = find_first_valid_interpreted(instructions, false);
+			} else {
+				part2 = find_first_valid_bytecode(instructions, false);
 			}
 			if (SOLVE_PART == BOTH) {
 				std::cout << "The biggest valid serial number is " << part1
@@ -349,9 +554,29 @@ void DayRunner<24>::solve(std::ifstream input) {
 		} else {
 			const long long int initial_regs[4] { 0 };
 			long long int registers[4];
-			run_program(instructions.data(), instructions.size(), initial_regs,
-					registers, INPUT_DIGITS,
-					sizeof(INPUT_DIGITS) / sizeof(char));
+			const size_t inpc = std::count_if(instructions.begin(),
+					instructions.end(), [](const Instruction &inst) -> bool {
+						return inst.type == InstType::INP;
+					});
+			if (use_jit && inpc <= sizeof(INPUT_DIGITS) / sizeof(char)) {
+				std::vector<uint8_t> code;
+				jit_compile(instructions.data(), instructions.size(), code);
+				const JitCode jit(code);
+				if (!jit.is_valid()) {
+					return;
+				}
+				jit.get_function(0)(initial_regs, registers, INPUT_DIGITS);
+			} else if (EXEC_MODE != INTERPRETE
+					&& inpc <= sizeof(INPUT_DIGITS) / sizeof(char)) {
+				std::vector<BytecodeOp> ops;
+				compile_bytecode(instructions.data(), instructions.size(), ops);
+				run_bytecode(ops.data(), initial_regs, registers, INPUT_DIGITS);
+			} else {
+				// Let the interpreter report missing input digits.
+				run_program(instructions.data(), instructions.size(),
+						initial_regs, registers, INPUT_DIGITS,
+						sizeof(INPUT_DIGITS) / sizeof(char));
+			}
 			std::cout << "The register values after running the program are w="
 					<< registers[0] << ", x=" << registers[1] << ", y="
 					<< registers[2] << ", z=" << registers[3] << '.'
@@ -361,10 +586,23 @@ void DayRunner<24>::solve(std::ifstream input) {
 
 	if (EXEC_MODE == COMPILE && tmpExe.has_value()
 			&& DELETE_COMPILATION_FILES) {
+		// The library has to be unloaded before it can be deleted on windows.
+		solver.reset();
 		delete_temp(tmpDir, tmpExe.value());
 	}
 }
 
+bool Instruction::operator ==(const Instruction &other) const {
+	return type == other.type && reg_a == other.reg_a
+			&& const_b == other.const_b && in_b == other.in_b;
+}
+
+SSAValue::SSAValue(const InstType t, const int64_t c, const int32_t a,
+		const int32_t b, const uint8_t h) :
+		type(t), constant(c), a(a), b(b), home(h), min(LLONG_MIN), max(
+				LLONG_MAX) {
+}
+
 std::ostream& operator <<(std::ostream &stream, const Instruction &inst) {
 	stream << inst.type;
 	if (inst.type != InstType::NOP) {
@@ -384,7 +622,8 @@ std::ostream& operator <<(std::ostream &stream, const Instruction &inst) {
 
 std::ostream& operator <<(std::ostream &stream, const InstType &type) {
 	if ((int) type >= 0
-			&& (int) type < sizeof(instTypeNames) / sizeof(instTypeNames[0])) {
+			&& (int) type
+					< (int) (sizeof(instTypeNames) / sizeof(instTypeNames[0]))) {
 		stream << instTypeNames[(unsigned int) type];
 	} else {
 		stream << "unknown(" << (int) type << ')';
@@ -395,7 +634,8 @@ std::ostream& operator <<(std::ostream &stream, const InstType &type) {
 
 std::ostream& operator <<(std::ostream &stream, const Compiler &comp) {
 	if ((int) comp >= 0
-			&& (int) comp < sizeof(compilerNames) / sizeof(compilerNames[0])) {
+			&& (int) comp
+					< (int) (sizeof(compilerNames) / sizeof(compilerNames[0]))) {
 		stream << compilerNames[(unsigned int) comp];
 	} else {
 		stream << "unknown(" << (int) comp << ')';
@@ -412,6 +652,224 @@ void print_instructions(const char *state,
 	}
 }
 
+template<typename T, size_t N>
+void read_setting(const std::string_view key,
+		const std::array<std::string_view, N> &names, T &setting) {
+	std::string_view value;
+	if (!aoc::getSetting(key, value)) {
+		return;
+	}
+
+	for (size_t i = 0; i < N; i++) {
+		if (names[i] == value) {
+			setting = (T) i;
+			return;
+		}
+	}
+
+	std::cerr << "Invalid value \"" << value << "\" for setting \"" << key
+			<< "\". Possible values are";
+	for (size_t i = 0; i < N; i++) {
+		std::cerr << (i == 0 ? " " : ", ") << names[i];
+	}
+	std::cerr << '.' << std::endl;
+}
+
+void read_settings() {
+	read_setting("exec_mode", EXEC_MODE_NAMES, EXEC_MODE);
+	read_setting("optimize", BOOL_NAMES, OPTIMIZE);
+	read_setting("report_passes", BOOL_NAMES, REPORT_PASSES);
+	read_setting("run_type", RUN_TYPE_NAMES, RUN_TYPE);
+	read_setting("solve_part", SOLVE_PART_NAMES, SOLVE_PART);
+	read_setting("delete_compilation_files", BOOL_NAMES,
+			DELETE_COMPILATION_FILES);
+	read_setting("cache_compilations", BOOL_NAMES, CACHE_COMPILATIONS);
+	read_setting("simd_mode", SIMD_MODE_NAMES, SIMD_MODE);
+	read_setting("simd_target", SIMD_TARGET_NAMES, SIMD_TARGET);
+	read_setting("benchmark_simd", BOOL_NAMES, BENCHMARK_SIMD);
+	read_setting("search_mode", SEARCH_MODE_NAMES, SEARCH_MODE);
+	read_setting("register_size", REGISTER_SIZE_NAMES, REGISTER_SIZE);
+	read_setting("sweep", BOOL_NAMES, SWEEP);
+
+	std::string_view value;
+	if (aoc::getSetting("verify_inputs", value)) {
+		std::string_view rest = value;
+		if (!aoc::parse::number(rest, VERIFY_INPUTS) || !rest.empty()) {
+			std::cerr << "Invalid value \"" << value
+					<< "\" for setting \"verify_inputs\"." << std::endl;
+		}
+	}
+
+	if (aoc::getSetting("print_instructions", value)) {
+		const std::array<std::string_view, 4> names { "never", "initial",
+				"optimized", "step" };
+		unsigned int print = NEVER;
+		while (true) {
+			const std::string_view name = value.substr(0, value.find(','));
+			const size_t index = std::find(names.begin(), names.end(), name)
+					- names.begin();
+			if (index == names.size()) {
+				std::cerr << "Invalid value \"" << name
+						<< "\" for setting \"print_instructions\"." << std::endl;
+				return;
+			}
+
+			// NEVER is 0, the others are single bits.
+			print |= (1 << index) >> 1;
+			if (name.length() == value.length()) {
+				break;
+			}
+			value = value.substr(name.length() + 1);
+		}
+		PRINT_INSTRUCTIONS = print;
+	}
+}
+
+std::vector<Instruction> optimize_instructions(
+		const std::vector<Instruction> &insts) {
+	std::vector<Instruction> instructions = insts;
+	// The name, iteration, resulting instruction count, and time of each pass run.
+	std::vector<std::tuple<const char*, size_t, size_t, double>> runs;
+	const auto run_pass = [&instructions, &runs](const OptimizationPass &pass,
+			const size_t iteration) {
+		const std::chrono::steady_clock::time_point start =
+				std::chrono::steady_clock::now();
+		{
+			aoc::phase timer(pass.name);
+			instructions = pass.run(instructions);
+		}
+		runs.push_back( { pass.name, iteration, instructions.size(),
+				std::chrono::duration<double>(
+						std::chrono::steady_clock::now() - start).count() });
+
+		if (PRINT_INSTRUCTIONS & STEP) {
+			std::ostringstream state;
+			state << "Post " << pass.name << " iteration " << iteration;
+			print_instructions(state.str().c_str(), instructions, std::cout);
+		}
+	};
+
+	size_t iterations = 0;
+	while (iterations < MAX_OPTIMIZATION_ITERATIONS) {
+		const std::vector<Instruction> previous = instructions;
+		iterations++;
+		for (const OptimizationPass &pass : OPTIMIZATION_PASSES) {
+			run_pass(pass, iterations);
+		}
+
+		if (instructions == previous) {
+			break;
+		}
+	}
+
+	// Reordering the instructions never allows the other passes to remove more of them.
+	run_pass( { "delay_input", delay_input }, iterations);
+
+	if (PRINT_INSTRUCTIONS & OPTIMIZED) {
+		print_instructions("Fully optimized", instructions, std::cout);
+	}
+
+	if (REPORT_PASSES) {
+		std::cout << "Optimized " << insts.size() << " instructions to "
+				<< instructions.size() << " in " << iterations
+				<< " iterations." << std::endl;
+		std::cout << std::left << std::setw(20) << "Pass" << std::setw(11)
+				<< "Iteration" << std::setw(14) << "Instructions" << "Time"
+				<< std::endl;
+		for (const std::tuple<const char*, size_t, size_t, double> &run : runs) {
+			std::ostringstream time_str;
+			time_str << std::fixed << std::setprecision(3)
+					<< std::get<3>(run) * 1000 << "ms";
+			std::cout << std::setw(20) << std::get<0>(run) << std::setw(11)
+					<< std::get<1>(run) << std::setw(14) << std::get<2>(run)
+					<< time_str.str() << std::endl;
+		}
+		std::cout << std::right;
+	}
+	return instructions;
+}
+
+bool verify_optimization(const std::vector<Instruction> &original,
+		const std::vector<Instruction> &optimized, const size_t count) {
+	const size_t inpc = std::count_if(original.begin(), original.end(),
+			[](const Instruction &inst) -> bool {
+				return inst.type == InstType::INP;
+			});
+
+	// Use a fixed seed, so failures can be reproduced.
+	std::mt19937_64 random(24);
+	std::uniform_int_distribution<int> digit(1, 9);
+	std::vector<char> inputs(count * inpc);
+	for (char &input : inputs) {
+		input = digit(random);
+	}
+
+	const std::vector<std::array<long long int, 4>> expected =
+			run_program_batch(original.data(), original.size(), inputs.data(),
+					inpc, count);
+	const std::vector<std::array<long long int, 4>> results =
+			run_program_batch(optimized.data(), optimized.size(),
+					inputs.data(), inpc, count);
+
+	size_t mismatches = 0;
+	for (size_t i = 0; i < count; i++) {
+		bool match = expected[i][3] == results[i][3];
+		// Only z is used when solving, so the other registers may be optimized away.
+		if (RUN_TYPE == EXECUTE) {
+			match &= expected[i] == results[i];
+		}
+
+		if (!match && mismatches++ == 0) {
+			std::cerr << "The optimized program returned the registers";
+			for (uint8_t j = 0; j < 4; j++) {
+				std::cerr << ' ' << (char) ('w' + j) << '=' << results[i][j];
+			}
+			std::cerr << " instead of";
+			for (uint8_t j = 0; j < 4; j++) {
+				std::cerr << ' ' << (char) ('w' + j) << '=' << expected[i][j];
+			}
+			std::cerr << " for the input ";
+			for (size_t j = 0; j < inpc; j++) {
+				std::cerr << (int16_t) inputs[i * inpc + j];
+			}
+			std::cerr << '.' << std::endl;
+		}
+	}
+
+	if (mismatches > 0) {
+		std::cerr << "The optimized program differed from the original for "
+				<< mismatches << " of " << count << " random inputs."
+				<< std::endl;
+		return false;
+	}
+
+	std::cout << "Verified the optimized program using " << count
+			<< " random inputs." << std::endl;
+	return true;
+}
+
+bool check_instructions(const std::vector<Instruction> &insts) {
+	for (size_t i = 0; i < insts.size(); i++) {
+		const Instruction inst = insts[i];
+		if (inst.type == InstType::DIV && inst.const_b && inst.in_b == 0) {
+			std::cerr << "Error: Instruction " << (i + 1) << '(' << inst
+					<< ") causes a division by zero." << std::endl;
+			return false;
+		}
+	}
+
+	if (RUN_TYPE == SOLVE
+			&& std::count_if(insts.begin(), insts.end(),
+					[](const Instruction &inst) -> bool {
+						return inst.type == InstType::INP;
+					}) != 14) {
+		std::cerr << "The input did not contain 14 input instructions."
+				<< std::endl;
+		return false;
+	}
+	return true;
+}
+
 std::vector<Instruction> static_eval(const std::vector<Instruction> &insts) {
 	std::vector<Instruction> result;
 
@@ -857,33 +1315,502 @@ std::vector<Instruction> merge_insts(const std::vector<Instruction> &insts) {
 	return result;
 }
 
-void run_program(const Instruction instsv[], const size_t instsc,
-		const long long int reg_vals[4], long long int *reg, const char inpv[],
-		const size_t inpc) {
-	reg[0] = reg_vals[0];
-	reg[1] = reg_vals[1];
-	reg[2] = reg_vals[2];
-	reg[3] = reg_vals[3];
+SSAProgram to_ssa(const std::vector<Instruction> &insts) {
+	SSAProgram program;
+	std::vector<SSAValue> &values = program.values;
+	std::map<int64_t, int32_t> constants;
+	const auto constant = [&values, &constants](const int64_t value) -> int32_t {
+		const std::map<int64_t, int32_t>::iterator found = constants.find(
+				value);
+		if (found != constants.end()) {
+			return found->second;
+		}
+
+		values.push_back(SSAValue(InstType::SET, value, -1, -1, 0));
+		constants[value] = values.size() - 1;
+		return values.size() - 1;
+	};
+
+	// The value currently held by each register.
+	int32_t *regs = program.outputs;
+	regs[0] = regs[1] = regs[2] = regs[3] = constant(0);
+	int64_t inputs = 0;
+	for (const Instruction &inst : insts) {
+		if (inst.type == InstType::NOP) {
+			continue;
+		} else if (inst.type == InstType::INP) {
+			values.push_back(
+					SSAValue(InstType::INP, inputs++, -1, -1, inst.reg_a));
+			regs[inst.reg_a] = values.size() - 1;
+			continue;
+		}
 
-	size_t inp = 0;
-	for (size_t i = 0; i < instsc; i++) {
-		const Instruction inst = instsv[i];
-		const int64_t in_b = inst.const_b ? inst.in_b : reg[inst.in_b];
-		switch (inst.type) {
-		case InstType::NOP:
-			break;
-		case InstType::INP:
-			if (inp >= inpc) {
-				std::cerr << "Trying to read input digit " << (inp + 1)
-						<< " when only " << inpc << " were given." << std::endl;
-				return;
+		const int32_t in_b =
+				inst.const_b ? constant(inst.in_b) : regs[inst.in_b];
+		if (inst.type == InstType::SET) {
+			regs[inst.reg_a] = in_b;
+		} else {
+			values.push_back(
+					SSAValue(inst.type, 0, regs[inst.reg_a], in_b, inst.reg_a));
+			regs[inst.reg_a] = values.size() - 1;
+		}
+	}
+
+	return program;
+}
+
+void ssa_set_range(SSAValue &value, const int64_t min, const int64_t max) {
+	if (min <= -RANGE_LIMIT || max >= RANGE_LIMIT) {
+		value.min = LLONG_MIN;
+		value.max = LLONG_MAX;
+	} else {
+		value.min = min;
+		value.max = max;
+	}
+}
+
+void ssa_calculate_range(const std::vector<SSAValue> &values,
+		SSAValue &value) {
+	const SSAValue &a = values[value.a];
+	const SSAValue &b = values[value.b];
+	const bool known = a.min != LLONG_MIN && b.min != LLONG_MIN;
+	switch (value.type) {
+	case InstType::ADD:
+		if (known) {
+			ssa_set_range(value, a.min + b.min, a.max + b.max);
+		} else {
+			ssa_set_range(value, LLONG_MIN, LLONG_MAX);
+		}
+		break;
+	case InstType::SUB:
+		if (value.a == value.b) {
+			ssa_set_range(value, 0, 0);
+		} else if (known) {
+			ssa_set_range(value, a.min - b.max, a.max - b.min);
+		} else {
+			ssa_set_range(value, LLONG_MIN, LLONG_MAX);
+		}
+		break;
+	case InstType::MUL:
+		if ((a.min == 0 && a.max == 0) || (b.min == 0 && b.max == 0)) {
+			ssa_set_range(value, 0, 0);
+		} else if (known) {
+			const int64_t corners[4][2] { { a.min, b.min }, { a.min, b.max }, {
+					a.max, b.min }, { a.max, b.max } };
+			int64_t min = LLONG_MAX;
+			int64_t max = LLONG_MIN;
+			for (const int64_t *corner : corners) {
+				// Checked using floating point numbers, because the product could overflow.
+				if (std::abs((double) corner[0] * corner[1]) >= RANGE_LIMIT) {
+					min = LLONG_MIN;
+					max = LLONG_MAX;
+					break;
+				}
+				min = std::min(min, corner[0] * corner[1]);
+				max = std::max(max, corner[0] * corner[1]);
 			}
-			reg[inst.reg_a] = inpv[inp++];
-			break;
-		case InstType::ADD:
-			reg[inst.reg_a] += in_b;
-			break;
-		case InstType::SUB:
+			ssa_set_range(value, min, max);
+		} else {
+			ssa_set_range(value, LLONG_MIN, LLONG_MAX);
+		}
+		break;
+	case InstType::DIV:
+		// Unknown ranges always contain zero.
+		if ((b.min <= 0 && b.max >= 0) || !known) {
+			ssa_set_range(value, LLONG_MIN, LLONG_MAX);
+		} else {
+			// Truncating division is monotonic in both inputs, as long as the divisor doesn't change its sign.
+			const int64_t corners[4] { a.min / b.min, a.min / b.max, a.max
+					/ b.min, a.max / b.max };
+			ssa_set_range(value, *std::min_element(corners, corners + 4),
+					*std::max_element(corners, corners + 4));
+		}
+		break;
+	case InstType::MOD:
+		if (b.min <= 0 && b.max >= 0) {
+			ssa_set_range(value, LLONG_MIN, LLONG_MAX);
+		} else {
+			// The remainder has the sign of the dividend, and is smaller than the divisor.
+			const int64_t limit = std::max(std::abs(b.min), std::abs(b.max))
+					- 1;
+			if (a.min == LLONG_MIN) {
+				ssa_set_range(value, -limit, limit);
+			} else {
+				ssa_set_range(value, a.min < 0 ? std::max(a.min, -limit) : 0,
+						a.max > 0 ? std::min(a.max, limit) : 0);
+			}
+		}
+		break;
+	case InstType::EQL:
+	case InstType::NEQ: {
+		const bool never = a.max < b.min || b.max < a.min;
+		const bool always = value.a == value.b
+				|| (a.min == a.max && b.min == b.max && a.min == b.min);
+		if (never || always) {
+			const int64_t result = always == (value.type == InstType::EQL);
+			ssa_set_range(value, result, result);
+		} else {
+			ssa_set_range(value, 0, 1);
+		}
+		break;
+	}
+	default:
+		ssa_set_range(value, LLONG_MIN, LLONG_MAX);
+	}
+}
+
+bool ssa_fold_ranges(SSAProgram &program) {
+	std::vector<SSAValue> &values = program.values;
+	// The value replacing each value. Values that weren't replaced replace themselves.
+	std::vector<int32_t> replace(values.size());
+	bool changed = false;
+	for (size_t i = 0; i < values.size(); i++) {
+		replace[i] = i;
+		SSAValue &value = values[i];
+		if (value.type == InstType::NOP) {
+			continue;
+		} else if (value.type == InstType::SET) {
+			value.min = value.max = value.constant;
+			continue;
+		} else if (value.type == InstType::INP) {
+			// The compiled solver and the search only ever use the digits 1 to 9.
+			if (RUN_TYPE == SOLVE) {
+				ssa_set_range(value, 1, 9);
+			} else {
+				ssa_set_range(value, CHAR_MIN, CHAR_MAX);
+			}
+			continue;
+		}
+
+		value.a = replace[value.a];
+		value.b = replace[value.b];
+		const SSAValue &a = values[value.a];
+		const SSAValue &b = values[value.b];
+		const bool a_zero = a.min == 0 && a.max == 0;
+		const bool b_zero = b.min == 0 && b.max == 0;
+		const bool a_one = a.min == 1 && a.max == 1;
+		const bool b_one = b.min == 1 && b.max == 1;
+
+		// Operations that don't change one of their inputs are replaced by that input.
+		int32_t input = -1;
+		if (((value.type == InstType::ADD || value.type == InstType::SUB)
+				&& b_zero)
+				|| ((value.type == InstType::MUL || value.type == InstType::DIV)
+						&& b_one)) {
+			input = value.a;
+		} else if ((value.type == InstType::ADD && a_zero)
+				|| (value.type == InstType::MUL && a_one)) {
+			input = value.b;
+		} else if (value.type == InstType::MOD && b.min == b.max && b.min != 0
+				&& a.min >= 0 && a.max < std::abs(b.min)) {
+			input = value.a;
+		}
+
+		if (input != -1) {
+			replace[i] = input;
+			value.type = InstType::NOP;
+			changed = true;
+			continue;
+		}
+
+		ssa_calculate_range(values, value);
+		// Constants have to fit into an instruction.
+		if (value.min == value.max && value.min >= INT32_MIN
+				&& value.max <= INT32_MAX) {
+			value.type = InstType::SET;
+			value.constant = value.min;
+			value.a = value.b = -1;
+			changed = true;
+		}
+	}
+
+	for (uint8_t i = 0; i < 4; i++) {
+		program.outputs[i] = replace[program.outputs[i]];
+	}
+	return changed;
+}
+
+bool ssa_eliminate_common(SSAProgram &program) {
+	std::vector<SSAValue> &values = program.values;
+	std::vector<int32_t> replace(values.size());
+	// The first value calculated by each operation, and its constant and inputs.
+	std::map<std::tuple<InstType, int64_t, int32_t, int32_t>, int32_t>
+			calculated;
+	bool changed = false;
+	for (size_t i = 0; i < values.size(); i++) {
+		replace[i] = i;
+		SSAValue &value = values[i];
+		if (value.type == InstType::NOP || value.type == InstType::INP) {
+			continue;
+		}
+
+		int32_t a = value.a;
+		int32_t b = value.b;
+		if (value.type != InstType::SET) {
+			a = value.a = replace[value.a];
+			b = value.b = replace[value.b];
+		}
+
+		// The order of the inputs of commutative operations doesn't matter.
+		if ((value.type == InstType::ADD || value.type == InstType::MUL
+				|| value.type == InstType::EQL || value.type == InstType::NEQ)
+				&& a > b) {
+			std::swap(a, b);
+		}
+
+		const std::pair<
+				std::map<std::tuple<InstType, int64_t, int32_t, int32_t>,
+						int32_t>::iterator, bool> inserted = calculated.emplace(
+				std::make_tuple(value.type, value.constant, a, b), i);
+		if (!inserted.second) {
+			replace[i] = inserted.first->second;
+			value.type = InstType::NOP;
+			changed = true;
+		}
+	}
+
+	for (uint8_t i = 0; i < 4; i++) {
+		program.outputs[i] = replace[program.outputs[i]];
+	}
+	return changed;
+}
+
+bool ssa_eliminate_dead(SSAProgram &program) {
+	std::vector<SSAValue> &values = program.values;
+	std::vector<bool> live(values.size(), false);
+	for (uint8_t i = 0; i < 4; i++) {
+		// Only z is checked after solving.
+		if (RUN_TYPE == EXECUTE || i == 3) {
+			live[program.outputs[i]] = true;
+		}
+	}
+
+	bool changed = false;
+	for (size_t i = values.size(); i > 0;) {
+		i--;
+		SSAValue &value = values[i];
+		if (value.type == InstType::NOP) {
+			continue;
+		} else if (!live[i] && value.type != InstType::INP) {
+			value.type = InstType::NOP;
+			changed = true;
+			continue;
+		}
+
+		if (value.a != -1) {
+			live[value.a] = true;
+		}
+		if (value.b != -1) {
+			live[value.b] = true;
+		}
+	}
+	return changed;
+}
+
+std::optional<std::vector<Instruction>> from_ssa(const SSAProgram &program,
+		const bool keep_home) {
+	const std::vector<SSAValue> &values = program.values;
+	const int32_t end = values.size();
+
+	// The index of the last value using each value, or -1 if it is unused.
+	std::vector<int32_t> last_use(values.size(), -1);
+	for (int32_t i = 0; i < end; i++) {
+		if (values[i].type != InstType::NOP && values[i].a != -1) {
+			last_use[values[i].a] = i;
+			last_use[values[i].b] = i;
+		}
+	}
+	// The register each value has to end up in, or -1 if it isn't a result.
+	std::vector<int8_t> targets(values.size(), -1);
+	for (uint8_t i = 0; i < 4; i++) {
+		if (RUN_TYPE == EXECUTE || i == 3) {
+			last_use[program.outputs[i]] = end;
+			targets[program.outputs[i]] = i;
+		}
+	}
+
+	// The value held by each register, and the register holding each value.
+	int32_t held[4] { -1, -1, -1, -1 };
+	std::vector<uint8_t> regs(values.size(), 0);
+	const auto is_free = [&held, &last_use](const int32_t i, const int8_t reg) {
+		return held[reg] == -1 || last_use[held[reg]] < i;
+	};
+	const auto find_free = [&is_free](const int32_t i,
+			const uint8_t preferred) -> int8_t {
+		for (uint8_t j = 0; j < 5; j++) {
+			const uint8_t reg = j == 0 ? preferred : j - 1;
+			if (is_free(i, reg)) {
+				return reg;
+			}
+		}
+		return -1;
+	};
+	const auto fits = [](const int64_t constant) {
+		return constant >= INT32_MIN && constant <= INT32_MAX;
+	};
+
+	std::vector<Instruction> result;
+	for (int32_t i = 0; i < end; i++) {
+		const SSAValue &value = values[i];
+		if (value.type == InstType::NOP || value.type == InstType::SET) {
+			// Constants are only written to registers when they are used.
+			continue;
+		}
+
+		// Writing results to the register they are expected in avoids moving them later.
+		const uint8_t preferred =
+				targets[i] == -1 ? value.home : (uint8_t) targets[i];
+		int8_t reg = -1;
+		int32_t in_b = value.b;
+		if (value.type == InstType::INP) {
+			reg = find_free(i, preferred);
+			if (reg == -1) {
+				return std::nullopt;
+			}
+			result.push_back(Instruction(InstType::INP, reg, true, 0));
+			held[reg] = i;
+			regs[i] = reg;
+			continue;
+		}
+
+		const SSAValue &a = values[value.a];
+		// Operations overriding an input that isn't used afterwards don't need an extra register.
+		const auto reusable = [&](const int32_t input) {
+			return values[input].type != InstType::SET
+					&& last_use[input] == i
+					&& (regs[input] == preferred
+							|| (!keep_home && targets[i] == -1)
+							|| !is_free(i, preferred));
+		};
+		if (reusable(value.a)) {
+			reg = regs[value.a];
+		} else if ((value.type == InstType::ADD || value.type == InstType::MUL
+				|| value.type == InstType::EQL || value.type == InstType::NEQ)
+				&& reusable(value.b)) {
+			reg = regs[value.b];
+			in_b = value.a;
+		} else {
+			reg = find_free(i, preferred);
+			if (reg == -1 || (a.type == InstType::SET && !fits(a.constant))) {
+				return std::nullopt;
+			} else if (a.type == InstType::SET) {
+				result.push_back(
+						Instruction(InstType::SET, reg, true, a.constant));
+			} else {
+				result.push_back(
+						Instruction(InstType::SET, reg, false, regs[value.a]));
+			}
+		}
+
+		const SSAValue &second = values[in_b];
+		if (second.type == InstType::SET) {
+			if (!fits(second.constant)) {
+				return std::nullopt;
+			}
+			result.push_back(
+					Instruction(value.type, reg, true, second.constant));
+		} else {
+			result.push_back(Instruction(value.type, reg, false, regs[in_b]));
+		}
+		held[reg] = i;
+		regs[i] = reg;
+	}
+
+	// Move the results to the registers they are expected in.
+	std::vector<std::pair<uint8_t, uint8_t>> moves;
+	for (uint8_t i = 0; i < 4; i++) {
+		const int32_t output = program.outputs[i];
+		if ((RUN_TYPE == EXECUTE || i == 3)
+				&& values[output].type != InstType::SET && regs[output] != i) {
+			moves.push_back( { i, regs[output] });
+		}
+	}
+
+	// A register can only be overridden once its value was moved.
+	const auto is_unblocked = [&moves](const std::pair<uint8_t, uint8_t> &move) {
+		for (const std::pair<uint8_t, uint8_t> &other : moves) {
+			if (other.second == move.first) {
+				return false;
+			}
+		}
+		return true;
+	};
+	while (!moves.empty()) {
+		const std::vector<std::pair<uint8_t, uint8_t>>::iterator move =
+				std::find_if(moves.begin(), moves.end(), is_unblocked);
+		if (move == moves.end()) {
+			// Swapping registers would require a fifth one.
+			return std::nullopt;
+		}
+		result.push_back(
+				Instruction(InstType::SET, move->first, false, move->second));
+		moves.erase(move);
+	}
+
+	for (uint8_t i = 0; i < 4; i++) {
+		const SSAValue &output = values[program.outputs[i]];
+		if ((RUN_TYPE == EXECUTE || i == 3) && output.type == InstType::SET) {
+			if (!fits(output.constant)) {
+				return std::nullopt;
+			}
+			result.push_back(
+					Instruction(InstType::SET, i, true, output.constant));
+		}
+	}
+
+	return result;
+}
+
+std::vector<Instruction> ssa_optimize(const std::vector<Instruction> &insts) {
+	SSAProgram program = to_ssa(insts);
+	bool changed = true;
+	for (size_t i = 0; changed && i < MAX_OPTIMIZATION_ITERATIONS; i++) {
+		changed = ssa_fold_ranges(program);
+		changed |= ssa_eliminate_common(program);
+		changed |= ssa_eliminate_dead(program);
+	}
+
+	// Keeping values in their home registers requires more moves,
+	// but the results can only be swapped into the expected registers using a fifth one.
+	std::vector<Instruction> result = insts;
+	for (const bool keep_home : { false, true }) {
+		const std::optional<std::vector<Instruction>> converted = from_ssa(
+				program, keep_home);
+		// The moves required to assign the registers can make the program longer.
+		if (converted.has_value() && converted->size() < result.size()) {
+			result = converted.value();
+		}
+	}
+	return result;
+}
+
+void run_program(const Instruction instsv[], const size_t instsc,
+		const long long int reg_vals[4], long long int *reg, const char inpv[],
+		const size_t inpc) {
+	reg[0] = reg_vals[0];
+	reg[1] = reg_vals[1];
+	reg[2] = reg_vals[2];
+	reg[3] = reg_vals[3];
+
+	size_t inp = 0;
+	for (size_t i = 0; i < instsc; i++) {
+		const Instruction inst = instsv[i];
+		const int64_t in_b = inst.const_b ? inst.in_b : reg[inst.in_b];
+		switch (inst.type) {
+		case InstType::NOP:
+			break;
+		case InstType::INP:
+			if (inp >= inpc) {
+				std::cerr << "Trying to read input digit " << (inp + 1)
+						<< " when only " << inpc << " were given." << std::endl;
+				return;
+			}
+			reg[inst.reg_a] = inpv[inp++];
+			break;
+		case InstType::ADD:
+			reg[inst.reg_a] += in_b;
+			break;
+		case InstType::SUB:
 			reg[inst.reg_a] -= in_b;
 			break;
 		case InstType::MUL:
@@ -911,9 +1838,590 @@ void run_program(const Instruction instsv[], const size_t instsc,
 	}
 }
 
-void find_first_runner_interpreted(const dynfunc funcs[14],
-		const std::array<uint8_t, 3> digits, std::atomic<int64_t> *result,
-		std::atomic<bool> *stop, const bool highest) {
+/**
+ * Attempts to fuse the given bytecode operation into the previous one.
+ *
+ * @param last	The previous operation, replaced with the fused operation if possible.
+ * @param op	The operation to fuse into the previous one.
+ * @return	True if the operations were fused, and op shouldn't be appended.
+ */
+bool fuse_bytecode(BytecodeOp &last, const BytecodeOp &op) {
+	if (last.reg_a != op.reg_a) {
+		return false;
+	}
+
+	switch (last.type) {
+	case BytecodeType::SET_R:
+		if (op.type == BytecodeType::ADD_I) {
+			last.type = BytecodeType::SET_ADD;
+		} else if (op.type == BytecodeType::MUL_I) {
+			last.type = BytecodeType::SET_MUL;
+		} else if (op.type == BytecodeType::MOD_I) {
+			last.type = BytecodeType::SET_MOD;
+		} else {
+			return false;
+		}
+		last.value = op.value;
+		return true;
+	case BytecodeType::SET_I:
+		// a = c * b, unless b is the register that was just set.
+		if (op.type == BytecodeType::MUL_R && op.reg_b != op.reg_a) {
+			last.type = BytecodeType::SET_MUL;
+			last.reg_b = op.reg_b;
+			return true;
+		}
+		return false;
+	case BytecodeType::MUL_I:
+		// "MUL a 0; ADD a b" is how unoptimized programs copy a register.
+		if (last.value == 0 && op.type == BytecodeType::ADD_R
+				&& op.reg_b != op.reg_a) {
+			last.type = BytecodeType::SET_R;
+			last.reg_b = op.reg_b;
+			return true;
+		}
+		return false;
+	case BytecodeType::MUL_R:
+		if (op.type == BytecodeType::ADD_I) {
+			last.type = BytecodeType::MUL_ADD;
+			last.value = op.value;
+			return true;
+		}
+		return false;
+	case BytecodeType::EQL_R:
+	case BytecodeType::EQL_I:
+	case BytecodeType::NEQ_R:
+	case BytecodeType::NEQ_I:
+		// Comparing a boolean to 0 negates it.
+		if (op.type == BytecodeType::EQL_I && op.value == 0) {
+			switch (last.type) {
+			case BytecodeType::EQL_R:
+				last.type = BytecodeType::NEQ_R;
+				break;
+			case BytecodeType::EQL_I:
+				last.type = BytecodeType::NEQ_I;
+				break;
+			case BytecodeType::NEQ_R:
+				last.type = BytecodeType::EQL_R;
+				break;
+			default:
+				last.type = BytecodeType::EQL_I;
+			}
+			return true;
+		}
+		return false;
+	default:
+		return false;
+	}
+}
+
+size_t compile_bytecode(const Instruction instsv[], const size_t instsc,
+		std::vector<BytecodeOp> &ops) {
+	const size_t offset = ops.size();
+	for (size_t i = 0; i < instsc; i++) {
+		const Instruction &inst = instsv[i];
+		BytecodeOp op { BytecodeType::END, inst.reg_a,
+				(uint8_t) (inst.const_b ? 0 : inst.in_b), inst.in_b };
+		const bool c = inst.const_b;
+		switch (inst.type) {
+		case InstType::NOP:
+			continue;
+		case InstType::INP:
+			op.type = BytecodeType::INP;
+			break;
+		case InstType::ADD:
+			op.type = c ? BytecodeType::ADD_I : BytecodeType::ADD_R;
+			break;
+		case InstType::SUB:
+			op.type = c ? BytecodeType::ADD_I : BytecodeType::SUB_R;
+			op.value = -op.value;
+			break;
+		case InstType::MUL:
+			op.type = c ? BytecodeType::MUL_I : BytecodeType::MUL_R;
+			break;
+		case InstType::DIV:
+			op.type = c ? BytecodeType::DIV_I : BytecodeType::DIV_R;
+			break;
+		case InstType::MOD:
+			op.type = c ? BytecodeType::MOD_I : BytecodeType::MOD_R;
+			break;
+		case InstType::EQL:
+			op.type = c ? BytecodeType::EQL_I : BytecodeType::EQL_R;
+			break;
+		case InstType::NEQ:
+			op.type = c ? BytecodeType::NEQ_I : BytecodeType::NEQ_R;
+			break;
+		case InstType::SET:
+			op.type = c ? BytecodeType::SET_I : BytecodeType::SET_R;
+			break;
+		default:
+			std::cerr << "Received unknown instruction " << inst.type << '.'
+					<< std::endl;
+			continue;
+		}
+
+		// Chains like "MUL a 0; ADD a b; MOD a c" are fused one operation at a time.
+		if (ops.size() > offset && fuse_bytecode(ops.back(), op)) {
+			continue;
+		}
+		ops.push_back(op);
+	}
+
+	ops.push_back( { BytecodeType::END, 0, 0, 0 });
+	return offset;
+}
+
+void run_bytecode(const BytecodeOp ops[], const long long int reg_vals[4],
+		long long int *reg, const char inpv[]) {
+	long long int r[4] { reg_vals[0], reg_vals[1], reg_vals[2], reg_vals[3] };
+	const BytecodeOp *op = ops;
+
+#if defined(__GNUC__)
+	// Computed goto dispatch, jumping directly from each operation to the next one.
+	static const void *const labels[] {
+#define Entry(a) &&op_##a
+			BytecodeTypes
+#undef Entry
+	};
+#define BYTECODE_OP(name) op_##name:
+#define BYTECODE_NEXT() goto *labels[(uint8_t) (++op)->type]
+	goto *labels[(uint8_t) op->type];
+#else
+#define BYTECODE_OP(name) case BytecodeType::name:
+#define BYTECODE_NEXT() op++; continue
+	for (;;) {
+		switch (op->type) {
+#endif
+
+	BYTECODE_OP(INP)
+		r[op->reg_a] = *inpv++;
+		BYTECODE_NEXT();
+	BYTECODE_OP(ADD_R)
+		r[op->reg_a] += r[op->reg_b];
+		BYTECODE_NEXT();
+	BYTECODE_OP(ADD_I)
+		r[op->reg_a] += op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(SUB_R)
+		r[op->reg_a] -= r[op->reg_b];
+		BYTECODE_NEXT();
+	BYTECODE_OP(MUL_R)
+		r[op->reg_a] *= r[op->reg_b];
+		BYTECODE_NEXT();
+	BYTECODE_OP(MUL_I)
+		r[op->reg_a] *= op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(DIV_R)
+		r[op->reg_a] /= r[op->reg_b];
+		BYTECODE_NEXT();
+	BYTECODE_OP(DIV_I)
+		r[op->reg_a] /= op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(MOD_R)
+		r[op->reg_a] %= r[op->reg_b];
+		BYTECODE_NEXT();
+	BYTECODE_OP(MOD_I)
+		r[op->reg_a] %= op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(EQL_R)
+		r[op->reg_a] = r[op->reg_a] == r[op->reg_b];
+		BYTECODE_NEXT();
+	BYTECODE_OP(EQL_I)
+		r[op->reg_a] = r[op->reg_a] == op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(NEQ_R)
+		r[op->reg_a] = r[op->reg_a] != r[op->reg_b];
+		BYTECODE_NEXT();
+	BYTECODE_OP(NEQ_I)
+		r[op->reg_a] = r[op->reg_a] != op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(SET_R)
+		r[op->reg_a] = r[op->reg_b];
+		BYTECODE_NEXT();
+	BYTECODE_OP(SET_I)
+		r[op->reg_a] = op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(SET_ADD)
+		r[op->reg_a] = r[op->reg_b] + op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(SET_MUL)
+		r[op->reg_a] = r[op->reg_b] * op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(SET_MOD)
+		r[op->reg_a] = r[op->reg_b] % op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(MUL_ADD)
+		r[op->reg_a] = r[op->reg_a] * r[op->reg_b] + op->value;
+		BYTECODE_NEXT();
+	BYTECODE_OP(END)
+		reg[0] = r[0];
+		reg[1] = r[1];
+		reg[2] = r[2];
+		reg[3] = r[3];
+		return;
+
+#if !defined(__GNUC__)
+		}
+	}
+#endif
+#undef BYTECODE_OP
+#undef BYTECODE_NEXT
+}
+
+/**
+ * The x86-64 register numbers of the ALU registers w, x, y, and z.
+ * The registers r8 to r11 aren't used by any other part of the generated code.
+ */
+const uint8_t JIT_REGS[4] { 8, 9, 10, 11 };
+
+/**
+ * The x86-64 register numbers of the other registers used by the generated code.
+ */
+enum JitReg {
+	RAX = 0, RCX = 1, RDX = 2, RSI = 6, RDI = 7
+};
+
+/**
+ * Appends a REX prefix for a register to register instruction to the given code.
+ *
+ * @param code	The machine code to append the prefix to.
+ * @param wide	Whether the instruction uses 64 bit operands.
+ * @param reg	The register in the reg field of the ModR/M byte.
+ * @param rm	The register in the r/m field of the ModR/M byte.
+ */
+void jit_rex(std::vector<uint8_t> &code, const bool wide, const uint8_t reg,
+		const uint8_t rm) {
+	const uint8_t rex = 0x40 | (wide << 3) | ((reg >> 3) << 2) | (rm >> 3);
+	if (rex != 0x40) {
+		code.push_back(rex);
+	}
+}
+
+/**
+ * Appends a 64 bit instruction with a register to register ModR/M byte to the given code.
+ *
+ * @param code		The machine code to append the instruction to.
+ * @param opcode	The opcode of the instruction. May be a two byte 0x0F opcode.
+ * @param reg		The register, or opcode extension, in the reg field of the ModR/M byte.
+ * @param rm		The register in the r/m field of the ModR/M byte.
+ */
+void jit_op(std::vector<uint8_t> &code, const uint16_t opcode,
+		const uint8_t reg, const uint8_t rm) {
+	jit_rex(code, true, reg, rm);
+	if (opcode > 0xFF) {
+		code.push_back(opcode >> 8);
+	}
+	code.push_back(opcode & 0xFF);
+	code.push_back(0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+/**
+ * Appends a 32 bit immediate value to the given code.
+ *
+ * @param code	The machine code to append the value to.
+ * @param imm	The value to append.
+ */
+void jit_imm32(std::vector<uint8_t> &code, const int32_t imm) {
+	for (uint8_t i = 0; i < 4; i++) {
+		code.push_back(((uint32_t) imm >> (i * 8)) & 0xFF);
+	}
+}
+
+/**
+ * Runs the given expression for every execution of the current block of run_program_batch,
+ * and writes the result to its primary register.
+ * The expression can use a[l] for the value of the primary register, and in_b for the secondary input.
+ */
+#define BATCH_LOOP(expr) \
+	if (inst.const_b) { \
+		const long long int in_b = inst.in_b; \
+		for (size_t l = 0; l < lanes; l++) { \
+			a[l] = expr; \
+		} \
+	} else { \
+		const long long int *b = &regs[inst.in_b * BATCH_BLOCK_SIZE]; \
+		for (size_t l = 0; l < lanes; l++) { \
+			const long long int in_b = b[l]; \
+			a[l] = expr; \
+		} \
+	}
+
+std::vector<std::array<long long int, 4>> run_program_batch(
+		const Instruction instsv[], const size_t instsc, const char inpv[],
+		const size_t inpc, const size_t count) {
+	std::vector<std::array<long long int, 4>> results(count);
+	// One array per register and input digit, with one value per execution of the current block.
+	std::vector<long long int> regs(4 * BATCH_BLOCK_SIZE);
+	std::vector<long long int> digits(inpc * BATCH_BLOCK_SIZE);
+	for (size_t start = 0; start < count; start += BATCH_BLOCK_SIZE) {
+		const size_t lanes = std::min(BATCH_BLOCK_SIZE, count - start);
+		std::fill(regs.begin(), regs.end(), 0);
+		for (size_t l = 0; l < lanes; l++) {
+			for (size_t i = 0; i < inpc; i++) {
+				digits[i * BATCH_BLOCK_SIZE + l] = inpv[(start + l) * inpc + i];
+			}
+		}
+
+		size_t inp = 0;
+		for (size_t i = 0; i < instsc; i++) {
+			const Instruction inst = instsv[i];
+			long long int *a = &regs[inst.reg_a * BATCH_BLOCK_SIZE];
+			switch (inst.type) {
+			case InstType::NOP:
+				break;
+			case InstType::INP:
+				if (inp >= inpc) {
+					std::cerr << "Trying to read input digit " << (inp + 1)
+							<< " when only " << inpc << " were given."
+							<< std::endl;
+					return results;
+				}
+				std::copy(&digits[inp * BATCH_BLOCK_SIZE],
+						&digits[inp * BATCH_BLOCK_SIZE + lanes], a);
+				inp++;
+				break;
+			case InstType::ADD:
+				BATCH_LOOP(a[l] + in_b)
+				break;
+			case InstType::SUB:
+				BATCH_LOOP(a[l] - in_b)
+				break;
+			case InstType::MUL:
+				BATCH_LOOP(a[l] * in_b)
+				break;
+			case InstType::DIV:
+				BATCH_LOOP(a[l] / in_b)
+				break;
+			case InstType::MOD:
+				BATCH_LOOP(a[l] % in_b)
+				break;
+			case InstType::EQL:
+				BATCH_LOOP(a[l] == in_b)
+				break;
+			case InstType::NEQ:
+				BATCH_LOOP(a[l] != in_b)
+				break;
+			case InstType::SET:
+				BATCH_LOOP(in_b)
+				break;
+			default:
+				std::cerr << "Received unknown instruction " << inst.type << '.'
+						<< std::endl;
+			}
+		}
+
+		for (size_t l = 0; l < lanes; l++) {
+			for (uint8_t r = 0; r < 4; r++) {
+				results[start + l][r] = regs[r * BATCH_BLOCK_SIZE + l];
+			}
+		}
+	}
+
+	return results;
+}
+
+#undef BATCH_LOOP
+
+bool jit_supported() {
+#ifdef JIT_SUPPORTED
+	return true;
+#else
+	return false;
+#endif
+}
+
+size_t jit_compile(const Instruction instsv[], const size_t instsc,
+		std::vector<uint8_t> &code) {
+	const size_t offset = code.size();
+
+	// System V calling convention: rdi = reg_vals, rsi = reg, rdx = inpv.
+	for (uint8_t i = 0; i < 4; i++) {
+		// mov r8+i, [rdi + i * 8]
+		jit_rex(code, true, JIT_REGS[i], RDI);
+		code.insert(code.end(),
+				{ 0x8B, (uint8_t) (0x40 | ((JIT_REGS[i] & 7) << 3) | RDI),
+						(uint8_t) (i * 8) });
+	}
+	// rdx is overwritten by idiv, so move the input pointer to rdi.
+	jit_op(code, 0x89, RDX, RDI);
+
+	int32_t inp = 0;
+	for (size_t i = 0; i < instsc; i++) {
+		const Instruction &inst = instsv[i];
+		const uint8_t reg_a = JIT_REGS[inst.reg_a];
+		const uint8_t reg_b = inst.const_b ? 0 : JIT_REGS[inst.in_b];
+		switch (inst.type) {
+		case InstType::NOP:
+			break;
+		case InstType::INP:
+			// movsx reg_a, byte [rdi + inp]
+			jit_rex(code, true, reg_a, RDI);
+			code.insert(code.end(),
+					{ 0x0F, 0xBE, (uint8_t) (0x80 | ((reg_a & 7) << 3) | RDI) });
+			jit_imm32(code, inp++);
+			break;
+		case InstType::ADD:
+		case InstType::SUB:
+			if (inst.const_b) {
+				jit_op(code, 0x81, inst.type == InstType::ADD ? 0 : 5, reg_a);
+				jit_imm32(code, inst.in_b);
+			} else {
+				jit_op(code, inst.type == InstType::ADD ? 0x01 : 0x29, reg_b,
+						reg_a);
+			}
+			break;
+		case InstType::MUL:
+			if (inst.const_b) {
+				jit_op(code, 0x69, reg_a, reg_a);
+				jit_imm32(code, inst.in_b);
+			} else {
+				jit_op(code, 0x0FAF, reg_a, reg_b);
+			}
+			break;
+		case InstType::DIV:
+		case InstType::MOD:
+			// mov rax, reg_a; cqo; idiv reg_b or rcx
+			jit_op(code, 0x89, reg_a, RAX);
+			code.insert(code.end(), { 0x48, 0x99 });
+			if (inst.const_b) {
+				jit_op(code, 0xC7, 0, RCX);
+				jit_imm32(code, inst.in_b);
+				jit_op(code, 0xF7, 7, RCX);
+			} else {
+				jit_op(code, 0xF7, 7, reg_b);
+			}
+			// The quotient is in rax, and the remainder in rdx.
+			jit_op(code, 0x89, inst.type == InstType::DIV ? RAX : RDX, reg_a);
+			break;
+		case InstType::EQL:
+		case InstType::NEQ:
+			if (inst.const_b) {
+				jit_op(code, 0x81, 7, reg_a);
+				jit_imm32(code, inst.in_b);
+			} else {
+				jit_op(code, 0x39, reg_b, reg_a);
+			}
+			// sete/setne al; movzx reg_a, al
+			code.insert(code.end(),
+					{ 0x0F, (uint8_t) (inst.type == InstType::EQL ? 0x94 : 0x95),
+							0xC0 });
+			jit_rex(code, false, reg_a, RAX);
+			code.insert(code.end(),
+					{ 0x0F, 0xB6, (uint8_t) (0xC0 | ((reg_a & 7) << 3) | RAX) });
+			break;
+		case InstType::SET:
+			if (inst.const_b) {
+				jit_op(code, 0xC7, 0, reg_a);
+				jit_imm32(code, inst.in_b);
+			} else {
+				jit_op(code, 0x89, reg_b, reg_a);
+			}
+			break;
+		default:
+			std::cerr << "Received unknown instruction " << inst.type << '.'
+					<< std::endl;
+		}
+	}
+
+	for (uint8_t i = 0; i < 4; i++) {
+		// mov [rsi + i * 8], r8+i
+		jit_rex(code, true, JIT_REGS[i], RSI);
+		code.insert(code.end(),
+				{ 0x89, (uint8_t) (0x40 | ((JIT_REGS[i] & 7) << 3) | RSI),
+						(uint8_t) (i * 8) });
+	}
+	code.push_back(0xC3);
+
+	return offset;
+}
+
+JitCode::JitCode(const std::vector<uint8_t> &code) :
+		memory(NULL), size(code.size()) {
+#ifdef JIT_SUPPORTED
+	// Never map memory writable and executable at the same time.
+	void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mem == MAP_FAILED) {
+		std::cerr << "Failed to allocate memory for the generated code."
+				<< std::endl;
+		return;
+	}
+
+	std::copy(code.begin(), code.end(), (uint8_t*) mem);
+	if (mprotect(mem, size, PROT_READ | PROT_EXEC) != 0) {
+		std::cerr << "Failed to make the generated code executable."
+				<< std::endl;
+		munmap(mem, size);
+		return;
+	}
+	memory = (uint8_t*) mem;
+#else
+	std::cerr
+			<< "Runtime code generation isn't supported on this platform."
+			<< std::endl;
+#endif
+}
+
+JitCode::~JitCode() {
+#ifdef JIT_SUPPORTED
+	if (memory) {
+		munmap(memory, size);
+	}
+#endif
+}
+
+bool JitCode::is_valid() const {
+	return memory != NULL;
+}
+
+jitfunc JitCode::get_function(const size_t offset) const {
+	return (jitfunc) (memory + offset);
+}
+
+CompiledSolver::CompiledSolver(const std::filesystem::path lib) :
+		handle(NULL) {
+#ifdef _WIN32
+	handle = (void*) LoadLibraryW(lib.c_str());
+	if (!handle) {
+		std::cerr << "Failed to load solver library " << lib
+				<< " with error code " << GetLastError() << '.' << std::endl;
+	}
+#else
+	// dlopen only searches the library path for file names without a separator.
+	handle = dlopen(std::filesystem::absolute(lib).c_str(),
+			RTLD_NOW | RTLD_LOCAL);
+	if (!handle) {
+		std::cerr << "Failed to load solver library " << lib << ": "
+				<< dlerror() << std::endl;
+	}
+#endif
+}
+
+CompiledSolver::~CompiledSolver() {
+	if (handle) {
+#ifdef _WIN32
+		FreeLibrary((HMODULE) handle);
+#else
+		dlclose(handle);
+#endif
+	}
+}
+
+bool CompiledSolver::is_valid() const {
+	return handle != NULL;
+}
+
+solverfunc CompiledSolver::get_function(const std::string &name) const {
+#ifdef _WIN32
+	return (solverfunc) GetProcAddress((HMODULE) handle, name.c_str());
+#else
+	return (solverfunc) dlsym(handle, name.c_str());
+#endif
+}
+
+template<typename F>
+int64_t find_first_runner(const F &run_segment,
+		const std::array<uint8_t, 3> digits, std::atomic<bool> *stop,
+		const bool highest) {
 	const uint16_t id = digits[0] * 100 + digits[1] * 10 + digits[2];
 	std::array<uint8_t, 14> num_in { digits[0], digits[1], digits[2], 9, 9, 9,
 			9, 9, 9, 9, 9, 9, 9, 9 };
@@ -924,9 +2432,9 @@ void find_first_runner_interpreted(const dynfunc funcs[14],
 
 	long long int registers[14][4];
 	const long long int start_reg[4] { 0 };
-	funcs[0](start_reg, registers[0], (char) num_in[0]);
+	run_segment(0, start_reg, registers[0], (char) num_in[0]);
 	for (uint8_t i = 1; i < 14; i++) {
-		funcs[i](registers[i - 1], registers[i], (char) num_in[i]);
+		run_segment(i, registers[i - 1], registers[i], (char) num_in[i]);
 	}
 
 	bool finished = false;
@@ -956,10 +2464,9 @@ void find_first_runner_interpreted(const dynfunc funcs[14],
 					num_in[i]++;
 				}
 
-				funcs[i](registers[i - 1], registers[i], (char) num_in[i]);
-
 				for (uint8_t j = i; j < 14; j++) {
-					funcs[j](registers[j - 1], registers[j], (char) num_in[j]);
+					run_segment(j, registers[j - 1], registers[j],
+							(char) num_in[j]);
 				}
 
 				if (print) {
@@ -980,222 +2487,676 @@ void find_first_runner_interpreted(const dynfunc funcs[14],
 		}
 	}
 
-	if (!finished) {
-		if (*stop) {
-			*result = -1;
-		} else {
-			*result = 0;
-			for (int i = 0; i < 14; i++) {
-				*result += num_in[i] * pow(10, 13 - i);
-			}
-			std::cout << "Thread " << id << " found number " << *result << '.'
-					<< std::endl;
-		}
-	} else {
-		*result = -1;
-		std::cout << "Thread " << id << " finished checking all its numbers."
-				<< std::endl;
+	if (finished) {
+		std::cout << "Thread " << id << " finished checking all its numbers."
+				<< std::endl;
+		return -1;
+	} else if (*stop) {
+		return -1;
+	}
+
+	int64_t result = 0;
+	for (uint8_t i = 0; i < 14; i++) {
+		result = result * 10 + num_in[i];
+	}
+	std::cout << "Thread " << id << " found number " << result << '.'
+			<< std::endl;
+	return result;
+}
+
+int64_t find_first_runner_compiled(const solverfunc solve_prefix,
+		const std::array<uint8_t, 3> digits, std::atomic<bool> *stop,
+		const bool highest) {
+	// The C solvers can't use std::atomic, so they read the flag as a volatile char.
+	static_assert(sizeof(std::atomic<bool>) == sizeof(char)
+			&& std::atomic<bool>::is_always_lock_free,
+			"The stop flag has to be readable as a plain char.");
+	const uint16_t id = digits[0] * 100 + digits[1] * 10 + digits[2];
+	const int64_t result = solve_prefix(digits.data(), highest,
+			reinterpret_cast<const volatile char*>(stop));
+	if (result == -1 && *stop) {
+		return -1;
+	} else if (result == -1) {
+		std::cout << "Thread " << id << " finished checking all its numbers."
+				<< std::endl;
+	} else {
+		std::cout << "Thread " << id << " found number " << result << '.'
+				<< std::endl;
+	}
+	return result;
+}
+
+SearchState::SearchState(const uint8_t seg, const long long int vals[4],
+		const uint8_t live) :
+		segment(seg) {
+	for (uint8_t i = 0; i < 4; i++) {
+		regs[i] = (live & (1 << i)) ? vals[i] : 0;
+	}
+}
+
+bool SearchState::operator ==(const SearchState &other) const {
+	return segment == other.segment && regs[0] == other.regs[0]
+			&& regs[1] == other.regs[1] && regs[2] == other.regs[2]
+			&& regs[3] == other.regs[3];
+}
+
+size_t std::hash<SearchState>::operator ()(const SearchState &to_hash) const {
+	uint64_t hash = to_hash.segment;
+	for (uint8_t i = 0; i < 4; i++) {
+		hash = (hash ^ (uint64_t) to_hash.regs[i]) * 0x9E3779B97F4A7C15ull;
+		hash ^= hash >> 29;
+	}
+	return hash;
+}
+
+DeadStateSet::shard& DeadStateSet::get_shard(const SearchState &state) {
+	// The low bits are used by the unordered_set, so use the high ones.
+	return shards[(std::hash<SearchState>()(state) >> 58) % SHARDS];
+}
+
+bool DeadStateSet::contains(const SearchState &state) {
+	shard &shard = get_shard(state);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	return shard.states.count(state) > 0;
+}
+
+void DeadStateSet::insert(const SearchState &state) {
+	shard &shard = get_shard(state);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	shard.states.insert(state);
+}
+
+size_t DeadStateSet::size() {
+	size_t size = 0;
+	for (shard &shard : shards) {
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		size += shard.states.size();
+	}
+	return size;
+}
+
+void find_live_registers(const std::vector<Instruction> &insts,
+		const size_t inps[15], uint8_t live_regs[14]) {
+	// Only z is checked after the last instruction.
+	uint8_t live = 0b1000;
+	uint8_t segment = 14;
+	for (size_t i = insts.size(); i > 0;) {
+		i--;
+		const Instruction &inst = insts[i];
+		if (inst.type == InstType::INP || inst.type == InstType::SET
+				|| (inst.type == InstType::MUL && inst.const_b
+						&& inst.in_b == 0)) {
+			// Instructions overriding their register don't read its previous value.
+			live &= ~(1 << inst.reg_a);
+		} else if (inst.type != InstType::NOP) {
+			live |= 1 << inst.reg_a;
+		}
+
+		if (inst.type != InstType::NOP && inst.type != InstType::INP
+				&& !inst.const_b) {
+			live |= 1 << inst.in_b;
+		}
+
+		if (segment > 0 && i == inps[segment - 1]) {
+			live_regs[--segment] = live;
+		}
+	}
+}
+
+template<typename F>
+bool find_valid_suffix(const F &run_segment, const uint8_t live_regs[14],
+		DeadStateSet &dead, const uint8_t segment,
+		const long long int reg_vals[4], std::array<uint8_t, 14> &digits,
+		std::atomic<bool> *stop, const bool highest) {
+	if (segment == 14) {
+		return reg_vals[3] == 0;
+	}
+
+	const SearchState state(segment, reg_vals, live_regs[segment]);
+	if (dead.contains(state)) {
+		return false;
+	}
+
+	long long int registers[4];
+	for (uint8_t i = 0; i < 9; i++) {
+		if (*stop) {
+			return false;
+		}
+
+		const uint8_t digit = highest ? 9 - i : i + 1;
+		run_segment(segment, reg_vals, registers, (char) digit);
+		if (find_valid_suffix(run_segment, live_regs, dead, segment + 1,
+				registers, digits, stop, highest)) {
+			digits[segment] = digit;
+			return true;
+		}
+	}
+
+	// Only states that were fully checked are dead.
+	if (!*stop) {
+		dead.insert(state);
+	}
+	return false;
+}
+
+template<typename F>
+int64_t find_first_runner_memoized(const F &run_segment,
+		const uint8_t live_regs[14], DeadStateSet *dead,
+		const std::array<uint8_t, 3> digits, std::atomic<bool> *stop,
+		const bool highest) {
+	const uint16_t id = digits[0] * 100 + digits[1] * 10 + digits[2];
+	std::array<uint8_t, 14> num_in { digits[0], digits[1], digits[2] };
+
+	long long int registers[4][4] { 0 };
+	for (uint8_t i = 0; i < 3; i++) {
+		run_segment(i, registers[i], registers[i + 1], (char) num_in[i]);
+	}
+
+	if (find_valid_suffix(run_segment, live_regs, *dead, 3, registers[3],
+			num_in, stop, highest)) {
+		int64_t number = 0;
+		for (uint8_t i = 0; i < 14; i++) {
+			number = number * 10 + num_in[i];
+		}
+		std::cout << "Thread " << id << " found number " << number << '.'
+				<< std::endl;
+		return number;
+	}
+
+	if (!*stop) {
+		std::cout << "Thread " << id << " finished checking all its numbers."
+				<< std::endl;
+	}
+	return -1;
+}
+
+bool find_segments(const std::vector<Instruction> &insts, size_t inps[15]) {
+	uint8_t in_i = 0;
+	for (size_t i = 0; i < insts.size(); i++) {
+		if (insts[i].type == InstType::INP) {
+			if (in_i == 14) {
+				in_i++;
+				break;
+			}
+			inps[in_i++] = i;
+		}
+	}
+
+	if (in_i != 14) {
+		std::cerr << "Input does not have 14 input instructions." << std::endl;
+		return false;
+	}
+
+	inps[in_i] = insts.size();
+	return true;
+}
+
+int64_t find_first_valid_interpreted(const std::vector<Instruction> insts,
+		const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix) {
+	size_t inps[15];
+	if (!find_segments(insts, inps)) {
+		return -1;
+	}
+
+	uint8_t live_regs[14];
+	find_live_registers(insts, inps, live_regs);
+
+	return find_first_valid(
+			[&insts, &inps](const uint8_t i, const long long int reg_vals[4],
+					long long int *reg, const char inp) {
+				run_program(&insts.data()[inps[i]], inps[i + 1] - inps[i],
+						reg_vals, reg, &inp, 1);
+			}, live_regs, highest, prefix);
+}
+
+int64_t find_first_valid_jit(const std::vector<Instruction> insts,
+		const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix) {
+	size_t inps[15];
+	if (!find_segments(insts, inps)) {
+		return -1;
+	}
+
+	uint8_t live_regs[14];
+	find_live_registers(insts, inps, live_regs);
+
+	std::vector<uint8_t> code;
+	size_t offsets[14];
+	for (size_t i = 0; i < 14; i++) {
+		offsets[i] = jit_compile(&insts.data()[inps[i]], inps[i + 1] - inps[i],
+				code);
 	}
-}
 
-void find_first_runner_compiled(const std::filesystem::path exe,
-		const std::array<uint8_t, 3> digits, std::atomic<int64_t> *result,
-		const bool highest) {
-	std::ostringstream cmd;
-	cmd << exe << ' ' << (uint16_t) digits[0] << ' ' << (uint16_t) digits[1]
-			<< ' ' << (uint16_t) digits[2] << ' '
-			<< (highest ? "true" : "false");
-	const int status = std::system(cmd.str().c_str());
-	if (status != 0) {
-		std::cerr << "Worker " << (uint16_t) digits[0] << (uint16_t) digits[1]
-				<< (uint16_t) digits[2] << " failed with exit code " << status
-				<< '.' << std::endl;
-		*result = -1;
-		return;
+	const JitCode jit(code);
+	if (!jit.is_valid()) {
+		std::cerr << "Falling back to interpreter." << std::endl;
+		return find_first_valid_bytecode(insts, highest, prefix);
+	}
+
+	jitfunc funcs[14];
+	for (size_t i = 0; i < 14; i++) {
+		funcs[i] = jit.get_function(offsets[i]);
 	}
 
-	std::filesystem::path tmpF = exe;
-	tmpF += digits[0] + '0';
-	tmpF += digits[1] + '0';
-	tmpF += digits[2] + '0';
-	std::ifstream tmpFI(tmpF);
-	long long int res;
-	tmpFI >> res;
-	*result = res;
-	tmpFI.close();
-	std::filesystem::remove(tmpF);
+	return find_first_valid(
+			[&funcs](const uint8_t i, const long long int reg_vals[4],
+					long long int *reg, const char inp) {
+				funcs[i](reg_vals, reg, &inp);
+			}, live_regs, highest, prefix);
 }
 
-int64_t find_first_valid_interpreted(const std::vector<Instruction> insts,
-		const bool highest) {
+int64_t find_first_valid_bytecode(const std::vector<Instruction> insts,
+		const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix) {
 	size_t inps[15];
-	uint8_t in_i = 0;
-	for (size_t i = 0; i < insts.size(); i++) {
-		if (insts[i].type == InstType::INP) {
-			inps[in_i++] = i;
-		}
+	if (!find_segments(insts, inps)) {
+		return -1;
 	}
-	inps[in_i] = insts.size();
 
-	if (in_i != 14) {
-		std::cerr << "Input does not have 14 input instructions." << std::endl;
-		return -1;
+	uint8_t live_regs[14];
+	find_live_registers(insts, inps, live_regs);
+
+	std::vector<BytecodeOp> ops;
+	size_t offsets[14];
+	for (size_t i = 0; i < 14; i++) {
+		offsets[i] = compile_bytecode(&insts.data()[inps[i]],
+				inps[i + 1] - inps[i], ops);
 	}
 
-	dynfunc funcs[14];
-	for (size_t i = 0; i < in_i; i++) {
-		funcs[i] = [insts, inps, i](const long long int reg_vals[4],
-				long long int *reg, const char inp) {
-			run_program(&insts.data()[inps[i]], inps[i + 1] - inps[i], reg_vals,
-					reg, &inp, 1);
-		};
+	const BytecodeOp *programs[14];
+	for (size_t i = 0; i < 14; i++) {
+		programs[i] = &ops.data()[offsets[i]];
 	}
 
-	int64_t result = 0;
-	std::atomic<bool> stop = false;
-	std::atomic<int64_t> results[18] { 0 };
-	std::thread threads[18];
-	for (uint8_t i = highest ? 81 : 1; highest ? (i > 0) : (i <= 81);
-			highest ? i-- : i++) {
-		for (uint8_t j = 9; j > 0; j--) {
-			const std::array<uint8_t, 3> digits { (uint8_t) ((i - 1) / 9 + 1),
-					(uint8_t) ((i - 1) % 9 + 1), j };
+	return find_first_valid(
+			[&programs](const uint8_t i, const long long int reg_vals[4],
+					long long int *reg, const char inp) {
+				run_bytecode(programs[i], reg_vals, reg, &inp);
+			}, live_regs, highest, prefix);
+}
 
-			threads[(i % 2) * 9 + j - 1] = std::thread(
-					find_first_runner_interpreted, funcs, digits,
-					&results[(i % 2) * 9 + j - 1], &stop, highest);
+template<typename F>
+int64_t find_first_valid(const F &run_segment, const uint8_t live_regs[14],
+		const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix) {
+	bool memoize = SEARCH_MODE == SEARCH_MEMOIZED;
+	if (SEARCH_MODE == SEARCH_AUTO) {
+		memoize = true;
+		for (uint8_t i = 0; i < 14; i++) {
+			uint8_t live = 0;
+			for (uint8_t j = 0; j < 4; j++) {
+				live += (live_regs[i] >> j) & 1;
+			}
+			memoize &= live <= 2;
 		}
+	}
 
-		if (highest && i == 81) {
-			continue;
-		} else if (!highest && i == 1) {
-			continue;
-		}
+	DeadStateSet dead;
+	int64_t result;
+	if (memoize) {
+		result = find_first_prefix(
+				[&run_segment, live_regs, &dead, highest](
+						const std::array<uint8_t, 3> digits,
+						std::atomic<bool> *stop) {
+					return find_first_runner_memoized(run_segment, live_regs,
+							&dead, digits, stop, highest);
+				}, highest, prefix);
+		std::cout << "Memoized " << dead.size() << " dead states." << std::endl;
+	} else {
+		result = find_first_prefix(
+				[&run_segment, highest](const std::array<uint8_t, 3> digits,
+						std::atomic<bool> *stop) {
+					return find_first_runner(run_segment, digits, stop,
+							highest);
+				}, highest, prefix);
+	}
 
-		bool second = (i % 2) == 0;
-		for (int8_t j = (highest ? 8 : 0); highest ? (j >= 0) : (j < 9);
-				highest ? j-- : j++) {
-			if (threads[j + second * 9].joinable()) {
-				threads[j + second * 9].join();
+	return result;
+}
+
+int64_t find_first_valid_compiled(const solverfunc solve_prefix,
+		const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix) {
+	return find_first_prefix(
+			[solve_prefix, highest](const std::array<uint8_t, 3> digits,
+					std::atomic<bool> *stop) {
+				return find_first_runner_compiled(solve_prefix, digits, stop,
+						highest);
+			}, highest, prefix);
+}
+
+solverfunc select_solver(const CompiledSolver &solver) {
+	if (SIMD_MODE != SIMD_DISABLED) {
+		const uint8_t supported =
+				SIMD_MODE == SIMD_ENABLED ?
+						1 << SIMD_TARGET : detect_simd_targets();
+		for (int8_t target = SIMD_TARGET; target >= 0; target--) {
+			if (!(supported & (1 << target))) {
+				continue;
 			}
 
-			if (result == 0 && results[j + second * 9] != -1) {
-				result = results[j + second * 9];
-				stop = true;
+			const solverfunc solve_prefix = solver.get_function(
+					std::string("solve_prefix_") + simdTargets[target].name);
+			if (solve_prefix) {
+				std::cout << "Using the " << simdTargets[target].name
+						<< " solver." << std::endl;
+				return solve_prefix;
 			}
 		}
+	}
 
-		if (result != 0) {
-			break;
-		}
+	const solverfunc solve_prefix = solver.get_function("solve_prefix");
+	if (!solve_prefix) {
+		std::cerr << "The solver library doesn't export a solve_prefix function."
+				<< std::endl;
 	}
+	return solve_prefix;
+}
 
-	for (int8_t i = highest ? 17 : 0; highest ? (i >= 0) : (i < 18);
-			highest ? i-- : i++) {
-		if (threads[i].joinable()) {
-			threads[i].join();
+void benchmark_simd_targets(const CompiledSolver &solver, const int64_t number,
+		const bool highest) {
+	const std::array<uint8_t, 3> digits {
+			(uint8_t) (number / 10000000000000ll % 10),
+			(uint8_t) (number / 1000000000000ll % 10),
+			(uint8_t) (number / 100000000000ll % 10) };
+	const uint8_t supported = detect_simd_targets();
+
+	std::cout << "Benchmarking the compiled solvers on prefix "
+			<< (uint16_t) digits[0] << (uint16_t) digits[1]
+			<< (uint16_t) digits[2] << '.' << std::endl;
+	std::cout << std::left << std::setw(10) << "Target" << std::setw(14)
+			<< "Time" << "Speedup" << std::endl;
+
+	double scalar_time = 0;
+	for (int8_t target = -1; target <= SIMD_TARGET; target++) {
+		if (target >= 0 && !(supported & (1 << target))) {
+			continue;
 		}
 
-		if (result == 0 && results[i] != -1) {
-			result = results[i];
-			stop = true;
+		const std::string name = target < 0 ? "scalar" : simdTargets[target].name;
+		const solverfunc solve_prefix = solver.get_function(
+				target < 0 ? "solve_prefix" : "solve_prefix_" + name);
+		if (!solve_prefix) {
+			continue;
+		}
+
+		const std::chrono::steady_clock::time_point start =
+				std::chrono::steady_clock::now();
+		const volatile char stop = 0;
+		const long long int result = solve_prefix(digits.data(), highest,
+				&stop);
+		const double time = std::chrono::duration<double>(
+				std::chrono::steady_clock::now() - start).count();
+		if (result != number) {
+			std::cerr << "The " << name << " solver found " << result
+					<< " instead of " << number << '.' << std::endl;
 		}
-	}
 
-	return result == 0 ? -1 : result;
+		if (scalar_time == 0) {
+			scalar_time = time;
+		}
+		std::ostringstream time_str;
+		time_str << std::fixed << std::setprecision(3) << time * 1000 << "ms";
+		std::ostringstream speedup_str;
+		speedup_str << std::fixed << std::setprecision(2) << scalar_time / time
+				<< 'x';
+		std::cout << std::setw(10) << name << std::setw(14) << time_str.str()
+				<< speedup_str.str() << std::endl;
+	}
+	std::cout << std::right;
 }
 
-int64_t find_first_valid_compiled(const std::filesystem::path exe,
-		const bool highest) {
-	int64_t result = 0;
-	std::atomic<int64_t> results[18] { 0 };
-	std::thread threads[18];
-	for (uint8_t i = highest ? 81 : 1; highest ? (i > 0) : (i <= 81);
-			highest ? i-- : i++) {
-		if (result == 0) {
-			for (uint8_t j = 9; j > 0; j--) {
-				const std::array<uint8_t, 3> digits {
-						(uint8_t) ((i - 1) / 9 + 1),
-						(uint8_t) ((i - 1) % 9 + 1), j };
+void sweep_configurations(const std::vector<Instruction> &insts) {
+	const SweepConfig initial { EXEC_MODE, OPTIMIZE, SEARCH_MODE, SIMD_MODE,
+			REGISTER_SIZE };
+	const unsigned int print_insts = PRINT_INSTRUCTIONS;
+	const auto apply = [](const SweepConfig &config) {
+		EXEC_MODE = config.exec_mode;
+		OPTIMIZE = config.optimize;
+		SEARCH_MODE = config.search_mode;
+		SIMD_MODE = config.simd_mode;
+		REGISTER_SIZE = config.register_size;
+	};
+
+	// Use the fastest search to find the number to benchmark.
+	const bool highest = SOLVE_PART != PART_2;
+	apply( { BYTECODE, true, SEARCH_AUTO, SIMD_MODE, REGISTER_SIZE });
+	const int64_t number = find_first_valid_bytecode(
+			optimize_instructions(insts), highest);
+	// Printing the instructions once is enough.
+	PRINT_INSTRUCTIONS = NEVER;
+	if (number == -1) {
+		std::cerr << "The input doesn't contain a valid number to benchmark."
+				<< std::endl;
+		apply(initial);
+		PRINT_INSTRUCTIONS = print_insts;
+		return;
+	}
 
-				// Use value -2 to mark that the thread is still running.
-				results[(i % 2) * 9 + j - 1] = -2;
-				threads[(i % 2) * 9 + j - 1] = std::thread(
-						find_first_runner_compiled, exe, digits,
-						&results[(i % 2) * 9 + j - 1], highest);
+	const std::array<uint8_t, 3> prefix {
+			(uint8_t) (number / 10000000000000ll % 10),
+			(uint8_t) (number / 1000000000000ll % 10),
+			(uint8_t) (number / 100000000000ll % 10) };
+
+	const Compiler compiler = detect_compiler();
+	std::vector<SweepConfig> configs;
+	for (const bool optimize : { false, true }) {
+		for (const ExecMode exec_mode : { INTERPRETE, BYTECODE, JIT }) {
+			if (exec_mode == JIT && !jit_supported()) {
+				continue;
+			}
+
+			for (const SearchMode search_mode : { SEARCH_BRUTE_FORCE,
+					SEARCH_MEMOIZED }) {
+				configs.push_back( { exec_mode, optimize, search_mode,
+						SIMD_DISABLED, REG_SIZE_32 });
 			}
 		}
 
-		if (highest && i == 81) {
-			continue;
-		} else if (!highest && i == 1) {
+		if (compiler == Compiler::NONE) {
 			continue;
 		}
 
-		bool second = (i % 2) == 0;
-		for (int8_t j = (highest ? 8 : 0); highest ? (j >= 0) : (j < 9);
-				highest ? j-- : j++) {
-			if (threads[j + second * 9].joinable()) {
-				threads[j + second * 9].join();
+		for (const SIMDMode simd_mode : { SIMD_DISABLED, SIMD_AUTO }) {
+			for (const RegSize register_size : { REG_SIZE_32, REG_SIZE_64 }) {
+				configs.push_back( { COMPILE, optimize, SEARCH_AUTO, simd_mode,
+						register_size });
 			}
+		}
+	}
 
-			if (result == 0 && results[j + second * 9] != -1) {
-				result = results[j + second * 9];
-			}
+	// The setup and search time of each configuration, or -1 if it failed.
+	std::vector<std::pair<double, double>> times;
+	for (const SweepConfig &config : configs) {
+		apply(config);
+		std::cout << "Benchmarking exec_mode=" << EXEC_MODE_NAMES[EXEC_MODE]
+				<< " optimize=" << BOOL_NAMES[OPTIMIZE];
+		if (EXEC_MODE == COMPILE) {
+			std::cout << " simd_mode=" << SIMD_MODE_NAMES[SIMD_MODE]
+					<< " register_size=" << REGISTER_SIZE_NAMES[REGISTER_SIZE];
+		} else {
+			std::cout << " search_mode=" << SEARCH_MODE_NAMES[SEARCH_MODE];
 		}
+		std::cout << " on prefix " << (uint16_t) prefix[0]
+				<< (uint16_t) prefix[1] << (uint16_t) prefix[2] << '.'
+				<< std::endl;
 
-		for (int8_t j = (highest ? 8 : 0); highest ? (j >= 0) : (j < 9);
-				highest ? j-- : j++) {
-			// The thread is still running, we can't get its result.
-			if (results[j + (!second) * 9] == -2) {
-				break;
-			}
+		const std::chrono::steady_clock::time_point start =
+				std::chrono::steady_clock::now();
+		const std::vector<Instruction> instructions =
+				OPTIMIZE ? optimize_instructions(insts) : insts;
+
+		int64_t result = -1;
+		double setup = -1;
+		std::chrono::steady_clock::time_point search_start;
+		if (EXEC_MODE == COMPILE) {
+			const std::filesystem::path tmpDir("tmp");
+			const std::optional<std::filesystem::path> tmpLib = create_temp_lib(
+					instructions, tmpDir, compiler);
+			if (tmpLib.has_value()) {
+				{
+					const CompiledSolver solver(tmpLib.value());
+					const solverfunc solve_prefix =
+							solver.is_valid() ? select_solver(solver) : NULL;
+					if (solve_prefix) {
+						search_start = std::chrono::steady_clock::now();
+						setup = std::chrono::duration<double>(
+								search_start - start).count();
+						result = find_first_valid_compiled(solve_prefix,
+								highest, prefix);
+					}
+				}
 
-			if (result == 0 && results[j + (!second) * 9] != -1) {
-				result = results[j + (!second) * 9];
-				break;
+				if (DELETE_COMPILATION_FILES) {
+					delete_temp(tmpDir, tmpLib.value());
+				}
+			}
+		} else {
+			search_start = std::chrono::steady_clock::now();
+			setup = std::chrono::duration<double>(search_start - start).count();
+			if (EXEC_MODE == JIT) {
+				result = find_first_valid_jit(instructions, highest, prefix);
+			} else if (EXEC_MODE == INTERPRETE) {
+				result = find_first_valid_interpreted(instructions, highest,
+						prefix);
+			} else {
+				result = find_first_valid_bytecode(instructions, highest,
+						prefix);
 			}
 		}
 
-		if (result != 0) {
-			break;
+		if (setup < 0) {
+			times.push_back( { -1, -1 });
+			continue;
+		}
+
+		times.push_back( { setup, std::chrono::duration<double>(
+				std::chrono::steady_clock::now() - search_start).count() });
+		if (result != number) {
+			std::cerr << "The configuration found " << result << " instead of "
+					<< number << '.' << std::endl;
+		}
+	}
+
+	apply(initial);
+	PRINT_INSTRUCTIONS = print_insts;
+
+	std::cout << "Results for prefix " << (uint16_t) prefix[0]
+			<< (uint16_t) prefix[1] << (uint16_t) prefix[2]
+			<< ", searched on a single thread:" << std::endl;
+	std::cout << std::left << std::setw(12) << "Exec mode" << std::setw(10)
+			<< "Optimize" << std::setw(13) << "Search mode" << std::setw(10)
+			<< "SIMD" << std::setw(11) << "Registers" << std::setw(14)
+			<< "Setup" << std::setw(14) << "Search" << "Speedup" << std::endl;
+	for (size_t i = 0; i < configs.size(); i++) {
+		const SweepConfig &config = configs[i];
+		const bool compiled = config.exec_mode == COMPILE;
+		std::cout << std::setw(12) << EXEC_MODE_NAMES[config.exec_mode]
+				<< std::setw(10) << BOOL_NAMES[config.optimize] << std::setw(13)
+				<< (compiled ? "-" : SEARCH_MODE_NAMES[config.search_mode])
+				<< std::setw(10)
+				<< (compiled ? SIMD_MODE_NAMES[config.simd_mode] : "-")
+				<< std::setw(11)
+				<< (compiled ? REGISTER_SIZE_NAMES[config.register_size] : "-");
+		if (times[i].first < 0) {
+			std::cout << "failed" << std::endl;
+			continue;
 		}
+
+		std::ostringstream setup_str;
+		setup_str << std::fixed << std::setprecision(3)
+				<< times[i].first * 1000 << "ms";
+		std::ostringstream search_str;
+		search_str << std::fixed << std::setprecision(3)
+				<< times[i].second * 1000 << "ms";
+		std::ostringstream speedup_str;
+		speedup_str << std::fixed << std::setprecision(2)
+				<< times[0].second / times[i].second << 'x';
+		std::cout << std::setw(14) << setup_str.str() << std::setw(14)
+				<< search_str.str() << speedup_str.str() << std::endl;
+	}
+	std::cout << std::right;
+}
+
+PrefixSearch::PrefixSearch() {
+	for (uint16_t i = 0; i < PREFIXES; i++) {
+		results[i] = -2;
+		stops[i] = false;
 	}
+	next = 0;
+}
 
-	for (int8_t i = highest ? 17 : 0; highest ? (i >= 0) : (i < 18);
-			highest ? i-- : i++) {
-		if (threads[i].joinable()) {
-			threads[i].join();
+template<typename S>
+void search_prefixes(PrefixSearch &search, const S &solve_prefix,
+		const bool highest) {
+	uint16_t index;
+	while ((index = search.next++) < PrefixSearch::PREFIXES) {
+		const uint16_t prefix =
+				highest ? PrefixSearch::PREFIXES - 1 - index : index;
+		const std::array<uint8_t, 3> digits { (uint8_t) (prefix / 81 + 1),
+				(uint8_t) (prefix / 9 % 9 + 1), (uint8_t) (prefix % 9 + 1) };
+
+		int64_t result = -1;
+		if (!search.stops[index]) {
+			result = solve_prefix(digits, &search.stops[index]);
+		}
+
+		if (result != -1) {
+			// Later prefixes can't win anymore, so there is no point in checking them.
+			for (uint16_t i = index + 1; i < PrefixSearch::PREFIXES; i++) {
+				search.stops[i] = true;
+			}
 		}
 
-		if (result == 0 && results[i] != -1) {
-			result = results[i];
+		{
+			// Setting the result while holding the lock prevents lost wakeups.
+			std::lock_guard<std::mutex> lock(search.mutex);
+			search.results[index] = result;
 		}
+		search.finished.notify_all();
 	}
-
-	return result == 0 ? -1 : result;
 }
 
-void generate_simd_call(std::ostream &out, const char *fn_name,
-		const char *regset, const uint16_t reg_a, const uint32_t in_b,
-		const bool const_b) {
-	out << "reg_" << regset << '[' << reg_a << "] = " << fn_name << "(reg_"
-			<< regset << '[' << reg_a << "], ";
-	if (const_b) {
-		if (REGISTER_SIZE == REG_SIZE_64) {
-			out << "_mm_set_epi64x(" << in_b << ", " << in_b << ')';
-		} else {
-			out << "_mm_set_epi32(" << in_b << ", " << in_b << ", " << in_b
-					<< ", " << in_b << ')';
+template<typename S>
+int64_t find_first_prefix(const S &solve_prefix, const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix) {
+	if (prefix.has_value()) {
+		std::atomic<bool> stop(false);
+		return solve_prefix(prefix.value(), &stop);
+	}
+
+	PrefixSearch search;
+	int64_t result = -1;
+	aoc::thread_pool pool;
+	for (size_t i = 0; i < pool.get_thread_count(); i++) {
+		pool.submit([&search, &solve_prefix, highest]() {
+			search_prefixes(search, solve_prefix, highest);
+		});
+	}
+
+	std::unique_lock<std::mutex> lock(search.mutex);
+	for (uint16_t i = 0; i < PrefixSearch::PREFIXES; i++) {
+		search.finished.wait(lock, [&search, i]() {
+			return search.results[i] != -2;
+		});
+
+		if (search.results[i] != -1) {
+			result = search.results[i];
+			break;
 		}
-	} else {
-		out << "reg_" << regset << '[' << in_b << ']';
 	}
-	out << ");" << std::endl;
+	lock.unlock();
+
+	// Stop the remaining prefixes, so the pool destructor doesn't wait for them.
+	for (uint16_t i = 0; i < PrefixSearch::PREFIXES; i++) {
+		search.stops[i] = true;
+	}
+	return result;
 }
 
 void generate_instruction_code(const Instruction &inst, std::ostream &out,
-		const uint16_t inp_idx, const bool simd) {
+		const uint16_t inp_idx) {
 	if (inst.type == InstType::NOP) {
 		return;
 	}
@@ -1206,214 +3167,18 @@ void generate_instruction_code(const Instruction &inst, std::ostream &out,
 
 	std::string padding = "    ";
 	if (RUN_TYPE == SOLVE) {
-		for (size_t i = 0; i < std::max(0, inp_idx - 3 - simd); i++) {
+		for (int i = 0; i < std::max(0, inp_idx - 3); i++) {
 			padding.append("    ");
 		}
 	}
 
-	if (simd) {
-		char regset_i[5] = { regset, '[', '0', ']', 0 };
-		const int num_regsets = REGISTER_SIZE == REG_SIZE_64 ? 4 : 2;
-		for (char i = 0; i < num_regsets; i++) {
-			regset_i[2] = i + '0';
-			switch (inst.type) {
-			case InstType::INP:
-				out << padding << "reg_" << regset_i << '['
-						<< static_cast<uint16_t>(inst.reg_a);
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					out << "] = _mm_set_epi64x(";
-					for (char j = 0; j < 2; j++) {
-						out << (i * 2 + j + 1);
-						if (j < 1) {
-							out << ", ";
-						}
-					}
-					out << ");" << std::endl;
-				} else {
-					out << "] = _mm_set_epi32(";
-					for (char j = 0; j < 4; j++) {
-						out << (i * 4 + j + 1);
-						if (j < 3) {
-							out << ", ";
-						}
-					}
-					out << ");" << std::endl;
-				}
-				break;
-			case InstType::ADD:
-				out << padding;
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					generate_simd_call(out, "_mm_add_epi64", regset_i,
-							inst.reg_a, inst.in_b, inst.const_b);
-				} else {
-					generate_simd_call(out, "_mm_add_epi32", regset_i,
-							inst.reg_a, inst.in_b, inst.const_b);
-				}
-				break;
-			case InstType::SUB:
-				out << padding;
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					generate_simd_call(out, "_mm_sub_epi64", regset_i,
-							inst.reg_a, inst.in_b, inst.const_b);
-				} else {
-					generate_simd_call(out, "_mm_sub_epi32", regset_i,
-							inst.reg_a, inst.in_b, inst.const_b);
-				}
-				break;
-			case InstType::MUL:
-				// For some reason there doesn't seem to be a 64 bit integer multiplication instruction.
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					out << padding << "reg_" << regset_i << '['
-							<< static_cast<uint16_t>(inst.reg_a)
-							<< "] = _mm_set_epi64x(";
-					for (int i = 1; i >= 0; i--) {
-						out << "_mm_extract_epi64(reg_" << regset_i << '['
-								<< static_cast<uint16_t>(inst.reg_a) << "], "
-								<< i << ") * ";
-						if (inst.const_b) {
-							out << inst.in_b;
-						} else {
-							out << "_mm_extract_epi64(reg_" << regset_i << '['
-									<< inst.in_b << "], " << i << ')';
-						}
-						if (i > 0) {
-							out << ", ";
-						}
-					}
-					out << ");" << std::endl;
-				} else {
-					out << padding;
-					generate_simd_call(out, "_mm_mullo_epi32", regset_i,
-							inst.reg_a, inst.in_b, inst.const_b);
-				}
-				break;
-			case InstType::DIV: {
-				std::string unit = "epi32";
-				short vals = 4;
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					unit = "epi64";
-					vals = 2;
-				}
-				out << padding << "reg_" << regset_i << '['
-						<< static_cast<uint16_t>(inst.reg_a);
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					out << "] = _mm_set_epi64x(";
-				} else {
-					out << "] = _mm_set_epi32(";
-				}
-				for (int i = vals - 1; i >= 0; i--) {
-					out << "_mm_extract_" << unit << "(reg_" << regset_i << '['
-							<< static_cast<uint16_t>(inst.reg_a) << "], " << i
-							<< ") / ";
-					if (inst.const_b) {
-						out << inst.in_b;
-					} else {
-						out << "_mm_extract_" << unit << "(reg_" << regset_i
-								<< '[' << inst.in_b << "], " << i << ')';
-					}
-					if (i > 0) {
-						out << ", ";
-					}
-				}
-				out << ");" << std::endl;
-				break;
-			}
-			case InstType::MOD: {
-				std::string unit = "epi32";
-				short vals = 4;
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					unit = "epi64";
-					vals = 2;
-				}
-				out << padding << "reg_" << regset_i << '['
-						<< static_cast<uint16_t>(inst.reg_a);
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					out << "] = _mm_set_epi64x(";
-				} else {
-					out << "] = _mm_set_epi32(";
-				}
-				for (int i = vals - 1; i >= 0; i--) {
-					out << "_mm_extract_" << unit << "(reg_" << regset_i << '['
-							<< static_cast<uint16_t>(inst.reg_a) << "], " << i
-							<< ") % ";
-					if (inst.const_b) {
-						out << inst.in_b;
-					} else {
-						out << "_mm_extract_" << unit << "(reg_" << regset_i
-								<< '[' << inst.in_b << "], " << i << ')';
-					}
-					if (i > 0) {
-						out << ", ";
-					}
-				}
-				out << ");" << std::endl;
-				break;
-			}
-			case InstType::EQL:
-				out << padding;
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					generate_simd_call(out, "_mm_cmpeq_epi64", regset_i,
-							inst.reg_a, inst.in_b, inst.const_b);
-				} else {
-					generate_simd_call(out, "_mm_cmpeq_epi32", regset_i,
-							inst.reg_a, inst.in_b, inst.const_b);
-				}
-				out << padding << "reg_" << regset_i << '['
-						<< static_cast<uint16_t>(inst.reg_a)
-						<< "] = _mm_and_si128(reg_" << regset_i << '['
-						<< static_cast<uint16_t>(inst.reg_a) << "], cmp_mask);"
-						<< std::endl;
-				break;
-			case InstType::NEQ:
-				out << padding;
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					generate_simd_call(out, "_mm_cmpeq_epi64", regset_i,
-							inst.reg_a, inst.in_b, inst.const_b);
-				} else {
-					generate_simd_call(out, "_mm_cmpeq_epi32", regset_i,
-							inst.reg_a, inst.in_b, inst.const_b);
-				}
-				out << padding << "reg_" << regset_i << '['
-						<< static_cast<uint16_t>(inst.reg_a)
-						<< "] = _mm_andnot_si128(reg_" << regset_i << '['
-						<< static_cast<uint16_t>(inst.reg_a) << "], cmp_mask);"
-						<< std::endl;
-				break;
-			case InstType::SET:
-				out << padding << "reg_" << regset_i << '['
-						<< static_cast<uint16_t>(inst.reg_a) << "] = ";
-				if (inst.const_b) {
-					if (REGISTER_SIZE == REG_SIZE_64) {
-						out << "_mm_set_epi64x(" << inst.in_b << ", "
-								<< inst.in_b << ");" << std::endl;
-					} else {
-						out << "_mm_set_epi32(" << inst.in_b << ", "
-								<< inst.in_b << ", " << inst.in_b << ", "
-								<< inst.in_b << ");" << std::endl;
-					}
-				} else {
-					out << "reg_" << regset_i << '[' << inst.in_b << "];"
-							<< std::endl;
-				}
-				break;
-			default:
-				// FIXME only print once
-				std::cerr << "Received unknown SIMD instruction type "
-						<< inst.type << '!' << std::endl;
-			}
-		}
-	}
-
-	const char *rs_sfx = simd ? "_e" : "";
-	out << padding << "reg_" << regset << rs_sfx << '['
+	out << padding << "reg_" << regset << '['
 			<< static_cast<uint16_t>(inst.reg_a) << ']';
 
 	switch (inst.type) {
 	case InstType::INP:
 		if (inp_idx < 4 || RUN_TYPE == EXECUTE) {
 			out << " = const_inputs[" << inp_idx - 1 << ']';
-		} else if (simd) {
-			out << " = 9";
 		} else {
 			out << " = reverse ? (10 - " << regset << ") : " << regset;
 		}
@@ -1434,12 +3199,12 @@ void generate_instruction_code(const Instruction &inst, std::ostream &out,
 		out << " %= ";
 		break;
 	case InstType::EQL:
-		out << " = reg_" << regset << rs_sfx << '['
-				<< static_cast<uint16_t>(inst.reg_a) << "] == ";
+		out << " = reg_" << regset << '[' << static_cast<uint16_t>(inst.reg_a)
+				<< "] == ";
 		break;
 	case InstType::NEQ:
-		out << " = reg_" << regset << rs_sfx << '['
-				<< static_cast<uint16_t>(inst.reg_a) << "] != ";
+		out << " = reg_" << regset << '[' << static_cast<uint16_t>(inst.reg_a)
+				<< "] != ";
 		break;
 	case InstType::SET:
 		out << " = ";
@@ -1449,23 +3214,308 @@ void generate_instruction_code(const Instruction &inst, std::ostream &out,
 				<< std::endl;
 	}
 
-	if (inst.type != InstType::INP) {
-		if (inst.const_b) {
-			out << inst.in_b;
-		} else {
-			out << "reg_" << regset << rs_sfx << '[' << inst.in_b << ']';
+	if (inst.type != InstType::INP) {
+		if (inst.const_b) {
+			out << inst.in_b;
+		} else {
+			out << "reg_" << regset << '[' << inst.in_b << ']';
+		}
+	}
+
+	out << ';' << std::endl;
+}
+
+void generate_simd_instruction(const Instruction &inst, std::ostream &out,
+		const SIMDInfo &simd, const char regset, const uint8_t vectors,
+		const std::string &indent) {
+	if (inst.type == InstType::NOP) {
+		return;
+	}
+
+	const bool wide = REGISTER_SIZE == REG_SIZE_64;
+	const char *unit = wide ? "epi64" : "epi32";
+	const char *lane_type = wide ? "long long int" : "int";
+	const uint8_t lanes = simd.bits / (wide ? 64 : 32);
+	const uint16_t reg_a = inst.reg_a;
+
+	// There is no vector integer division, so divide each lane on its own.
+	if (inst.type == InstType::DIV || inst.type == InstType::MOD) {
+		const char op = inst.type == InstType::DIV ? '/' : '%';
+		out << indent << '{' << std::endl;
+		out << indent << "    " << lane_type << " lanes_a[" << vectors * lanes
+				<< "];" << std::endl;
+		if (!inst.const_b) {
+			out << indent << "    " << lane_type << " lanes_b["
+					<< vectors * lanes << "];" << std::endl;
+		}
+		for (uint8_t v = 0; v < vectors; v++) {
+			out << indent << "    " << simd.prefix << "_storeu_" << simd.si
+					<< "((" << simd.type << "*) &lanes_a[" << v * lanes
+					<< "], vreg_" << regset << '[' << (uint16_t) v << "]["
+					<< reg_a << "]);" << std::endl;
+			if (!inst.const_b) {
+				out << indent << "    " << simd.prefix << "_storeu_" << simd.si
+						<< "((" << simd.type << "*) &lanes_b[" << v * lanes
+						<< "], vreg_" << regset << '[' << (uint16_t) v << "]["
+						<< inst.in_b << "]);" << std::endl;
+			}
+		}
+		out << indent << "    for (int lane = 0; lane < " << vectors * lanes
+				<< "; lane++) {" << std::endl;
+		out << indent << "        lanes_a[lane] " << op << "= ";
+		if (inst.const_b) {
+			out << inst.in_b;
+		} else {
+			out << "lanes_b[lane]";
+		}
+		out << ';' << std::endl;
+		out << indent << "    }" << std::endl;
+		for (uint8_t v = 0; v < vectors; v++) {
+			out << indent << "    vreg_" << regset << '[' << (uint16_t) v
+					<< "][" << reg_a << "] = " << simd.prefix << "_loadu_"
+					<< simd.si << "((const " << simd.type << "*) &lanes_a["
+					<< v * lanes << "]);" << std::endl;
+		}
+		out << indent << '}' << std::endl;
+		return;
+	}
+
+	for (uint8_t v = 0; v < vectors; v++) {
+		std::ostringstream reg_a_str;
+		reg_a_str << "vreg_" << regset << '[' << (uint16_t) v << "][" << reg_a
+				<< ']';
+		std::ostringstream in_b_str;
+		if (inst.const_b) {
+			if (wide) {
+				in_b_str << simd.set1_64 << '(' << inst.in_b << ')';
+			} else {
+				in_b_str << simd.prefix << "_set1_epi32(" << inst.in_b << ')';
+			}
+		} else {
+			in_b_str << "vreg_" << regset << '[' << (uint16_t) v << "]["
+					<< inst.in_b << ']';
+		}
+		const std::string a_str = reg_a_str.str();
+		const std::string b_str = in_b_str.str();
+
+		out << indent << a_str << " = ";
+		switch (inst.type) {
+		case InstType::INP:
+			out << simd.prefix << "_loadu_" << simd.si << "((const "
+					<< simd.type << "*) &digits[" << v * lanes << "])";
+			break;
+		case InstType::ADD:
+			out << simd.prefix << "_add_" << unit << '(' << a_str << ", "
+					<< b_str << ')';
+			break;
+		case InstType::SUB:
+			out << simd.prefix << "_sub_" << unit << '(' << a_str << ", "
+					<< b_str << ')';
+			break;
+		case InstType::MUL:
+			if (wide && simd.bits < 512) {
+				// Only AVX-512 has a 64 bit multiplication, so combine 32 bit ones.
+				// The high halves of both products are shifted out, so this also works for negative numbers.
+				const std::string p = simd.prefix;
+				out << p << "_add_epi64(" << p << "_mul_epu32(" << a_str << ", "
+						<< b_str << "), " << p << "_slli_epi64(" << p
+						<< "_add_epi64(" << p << "_mul_epu32(" << p
+						<< "_srli_epi64(" << a_str << ", 32), " << b_str
+						<< "), " << p << "_mul_epu32(" << a_str << ", " << p
+						<< "_srli_epi64(" << b_str << ", 32))), 32))";
+			} else {
+				out << simd.prefix << "_mullo_" << unit << '(' << a_str << ", "
+						<< b_str << ')';
+			}
+			break;
+		case InstType::EQL:
+		case InstType::NEQ:
+			if (simd.bits == 512) {
+				// AVX-512 comparisons return a bit mask instead of a vector.
+				out << simd.prefix << "_maskz_mov_" << unit << '('
+						<< simd.prefix
+						<< (inst.type == InstType::EQL ? "_cmpeq_" : "_cmpneq_")
+						<< unit << "_mask(" << a_str << ", " << b_str
+						<< "), ones)";
+			} else {
+				out << simd.prefix
+						<< (inst.type == InstType::EQL ? "_and_" : "_andnot_")
+						<< simd.si << '(' << simd.prefix << "_cmpeq_" << unit
+						<< '(' << a_str << ", " << b_str << "), ones)";
+			}
+			break;
+		case InstType::SET:
+			out << b_str;
+			break;
+		default:
+			std::cerr << "Received unknown SIMD instruction type " << inst.type
+					<< '!' << std::endl;
+		}
+		out << ';' << std::endl;
+	}
+}
+
+void generate_solver_result(std::ostream &out, const std::string &indent) {
+	out << indent
+			<< "long long int result = const_inputs[0] * 10000000000000ll + "
+			<< "const_inputs[1] * 1000000000000ll + const_inputs[2] * 100000000000ll;"
+			<< std::endl;
+	out << indent << "if (reverse) {" << std::endl;
+	out << indent << "    result += ";
+	for (short i = 10; i >= 0; i--) {
+		out << "(10 - " << static_cast<char>('s' - i) << ") * 1";
+		for (short j = 0; j < i; j++) {
+			out << '0';
+		}
+		out << "ll";
+		if (i > 0) {
+			out << " + ";
+		}
+	}
+	out << ';' << std::endl;
+	out << indent << "} else {" << std::endl;
+	out << indent << "    result += ";
+	for (short i = 10; i >= 0; i--) {
+		out << static_cast<char>('s' - i) << " * 1";
+		for (short j = 0; j < i; j++) {
+			out << '0';
+		}
+		out << "ll";
+		if (i > 0) {
+			out << " + ";
+		}
+	}
+	out << ';' << std::endl;
+	out << indent << '}' << std::endl;
+}
+
+void generate_simd_solver(const std::vector<Instruction> &insts,
+		std::ostream &out, const SIMDInfo &simd, const size_t inps[15],
+		const uint8_t live_regs[14]) {
+	const bool wide = REGISTER_SIZE == REG_SIZE_64;
+	const char *lane_type = wide ? "long long int" : "int";
+	const uint8_t lanes = simd.bits / (wide ? 64 : 32);
+	const uint8_t vectors = (9 + lanes - 1) / lanes;
+
+	out << "#if defined(__GNUC__) || defined(__clang__)" << std::endl;
+	out << "__attribute__((target(\"" << simd.target << "\")))" << std::endl;
+	out << "#endif" << std::endl;
+	out << "EXPORT long long int solve_prefix_" << simd.name
+			<< "(const unsigned char const_inputs[3], const char reverse, const volatile char *stop) {"
+			<< std::endl;
+	// The lanes after the ninth repeat the last digit, so they can't fail where the real ones wouldn't.
+	out << "    static const " << lane_type << " digits_high["
+			<< vectors * lanes << "] = { ";
+	for (uint8_t i = 0; i < vectors * lanes; i++) {
+		out << (i < 9 ? 9 - i : 1) << (i + 1 < vectors * lanes ? ", " : " };");
+	}
+	out << std::endl;
+	out << "    static const " << lane_type << " digits_low["
+			<< vectors * lanes << "] = { ";
+	for (uint8_t i = 0; i < vectors * lanes; i++) {
+		out << (i < 9 ? i + 1 : 9) << (i + 1 < vectors * lanes ? ", " : " };");
+	}
+	out << std::endl;
+	out << "    const " << lane_type
+			<< " *digits = reverse ? digits_high : digits_low;" << std::endl;
+	out << "    const " << simd.type << " ones = ";
+	if (wide) {
+		out << simd.set1_64 << "(1);" << std::endl;
+	} else {
+		out << simd.prefix << "_set1_epi32(1);" << std::endl;
+	}
+	out << "    " << lane_type << " reg_h[4];" << std::endl;
+
+	uint16_t inp_idx = 0;
+	for (size_t i = 0; i < inps[3]; i++) {
+		if (insts[i].type == InstType::INP) {
+			inp_idx++;
+		}
+		generate_instruction_code(insts[i], out, inp_idx);
+	}
+
+	std::string indent = "    ";
+	for (uint8_t segment = 3; segment < 14; segment++) {
+		const char regset = 'i' + segment - 3;
+		const char prev_regset = segment == 3 ? 'h' : regset - 1;
+
+		out << std::endl;
+		out << indent << simd.type << " vreg_" << regset << '['
+				<< (uint16_t) vectors << "][4];" << std::endl;
+		for (uint16_t j = 0; j < 4; j++) {
+			for (uint8_t v = 0; v < vectors; v++) {
+				out << indent << "vreg_" << regset << '[' << (uint16_t) v
+						<< "][" << j << "] = ";
+				if (!(live_regs[segment] & (1 << j))) {
+					out << simd.prefix << "_setzero_" << simd.si << "();";
+				} else if (wide) {
+					out << simd.set1_64 << "(reg_" << prev_regset << '[' << j
+							<< "]);";
+				} else {
+					out << simd.prefix << "_set1_epi32(reg_" << prev_regset
+							<< '[' << j << "]);";
+				}
+				out << std::endl;
+			}
+		}
+
+		for (size_t i = inps[segment]; i < inps[segment + 1]; i++) {
+			generate_simd_instruction(insts[i], out, simd, regset, vectors,
+					indent);
+		}
+
+		// Only z is checked after the last segment.
+		const uint8_t live_out = segment < 13 ? live_regs[segment + 1] : 0b1000;
+		out << indent << lane_type << " lanes_" << regset << "[4]["
+				<< vectors * lanes << "];" << std::endl;
+		for (uint16_t j = 0; j < 4; j++) {
+			if (live_out & (1 << j)) {
+				for (uint8_t v = 0; v < vectors; v++) {
+					out << indent << simd.prefix << "_storeu_" << simd.si
+							<< "((" << simd.type << "*) &lanes_" << regset
+							<< '[' << j << "][" << v * lanes << "], vreg_"
+							<< regset << '[' << (uint16_t) v << "][" << j
+							<< "]);" << std::endl;
+				}
+			}
+		}
+
+		out << indent << "for (char " << regset << " = 1; " << regset
+				<< " < 10; " << regset << "++) {" << std::endl;
+		indent.append("    ");
+		if (segment < STOP_CHECK_DIGITS) {
+			out << indent << "if (*stop) {" << std::endl;
+			out << indent << "    return -1;" << std::endl;
+			out << indent << '}' << std::endl;
+		}
+		if (segment < 13) {
+			out << indent << lane_type << " reg_" << regset << "[4];"
+					<< std::endl;
+			for (uint16_t j = 0; j < 4; j++) {
+				if (live_out & (1 << j)) {
+					out << indent << "reg_" << regset << '[' << j
+							<< "] = lanes_" << regset << '[' << j << "]["
+							<< regset << " - 1];" << std::endl;
+				}
+			}
 		}
 	}
 
-	out << ';' << std::endl;
+	out << indent << "if (lanes_s[3][s - 1] == 0) {" << std::endl;
+	generate_solver_result(out, indent + "    ");
+	out << indent << "    return result;" << std::endl;
+	out << indent << '}' << std::endl;
+	for (uint8_t segment = 3; segment < 14; segment++) {
+		indent.erase(indent.size() - 4);
+		out << indent << '}' << std::endl;
+	}
+	out << "    return -1;" << std::endl;
+	out << '}' << std::endl;
 }
 
 bool compile_instructions(const std::vector<Instruction> insts,
-		const std::filesystem::path tmpDir, const Compiler comp) {
-	const bool simd_enabled = SIMD_MODE == SIMD_ENABLED
-			|| (SIMD_MODE == SIMD_AUTO
-					&& detect_simd(comp, tmpDir).value_or(false));
-
+		const std::filesystem::path tmpDir, const Compiler comp,
+		const bool simd) {
 	std::filesystem::path tmpC(tmpDir);
 	tmpC += std::filesystem::path::preferred_separator;
 	tmpC += "solver.c";
@@ -1492,7 +3542,7 @@ bool compile_instructions(const std::vector<Instruction> insts,
 		reg_format = "%lld";
 	}
 
-	std::ofstream tmpCO(tmpC);
+	std::ostringstream tmpCO;
 	tmpCO << "/**" << std::endl;
 	tmpCO << " * This source file was automatically generated" << std::endl;
 	tmpCO
@@ -1504,7 +3554,7 @@ bool compile_instructions(const std::vector<Instruction> insts,
 	tmpCO
 			<< " * so manually modifying it is unlikely to yield the desired results."
 			<< std::endl;
-	if (simd_enabled) {
+	if (simd) {
 		tmpCO << " *" << std::endl;
 		tmpCO << " * This file was generated with SIMD support enabled."
 				<< std::endl;
@@ -1513,75 +3563,21 @@ bool compile_instructions(const std::vector<Instruction> insts,
 	tmpCO << "#include <stdio.h>" << std::endl;
 	tmpCO << "#include <stdlib.h>" << std::endl;
 	tmpCO << "#include <string.h>" << std::endl;
-	if (simd_enabled) {
+	if (simd) {
 		tmpCO << "#include <immintrin.h>" << std::endl;
 	}
 	tmpCO << std::endl;
-	// MSVC doesn't have a compiler support check for this, as far as I can tell.
-	if (simd_enabled && comp != Compiler::CL) {
-		tmpCO << "#ifndef __SSE4_1__" << std::endl;
-		tmpCO << "#error This version of the solver requires SSE4.1 support."
-				<< std::endl;
-		tmpCO << "#error Please regenerate this file without SIMD enabled."
-				<< std::endl;
-		tmpCO << "#endif" << std::endl << std::endl;
-	}
-	tmpCO << "int main(const int argc, char *argv[]) {" << std::endl;
 	if (RUN_TYPE == SOLVE) {
-		tmpCO << "    if (argc < 5) {" << std::endl;
-		tmpCO
-				<< "        fputs(\"Error: This program requires three input digits and a boolean to operate.\\n\", stderr);"
-				<< std::endl;
-		tmpCO
-				<< "        fputs(\"Format: DIGIT_1 DIGIT_2 DIGIT_3 REVERSE\\n\", stderr);"
-				<< std::endl;
-		tmpCO << "        return 1;" << std::endl;
-		tmpCO << "    }" << std::endl << std::endl;
-		tmpCO << "    unsigned char const_inputs[3];" << std::endl;
-		tmpCO << "    for (char i = 0; i < 3; i++) {" << std::endl;
-		tmpCO
-				<< "        if (argv[i + 1][0] < '0' || argv[i + 1][0] > '9' || strlen(argv[i + 1]) != 1) {"
-				<< std::endl;
-		tmpCO
-				<< "            fprintf(stderr, \"DIGIT_%d wasn't a digit. Was %s.\\n\", i, argv[i + 1]);"
-				<< std::endl;
-		tmpCO << "            return 1;" << std::endl;
-		tmpCO << "        }" << std::endl;
-		tmpCO << "        const_inputs[i] = argv[i + 1][0] - '0';" << std::endl;
-		tmpCO << "    }" << std::endl << std::endl;
-		tmpCO << "    for (size_t i = 0; i < strlen(argv[4]); i++) {"
-				<< std::endl;
-		tmpCO << "        if (argv[4][i] >= 'A' && argv[4][i] <= 'Z') {"
-				<< std::endl;
-		tmpCO << "            argv[4][i] += 32;" << std::endl;
-		tmpCO << "        }" << std::endl;
-		tmpCO << "    }" << std::endl << std::endl;
-		tmpCO << "    const char reverse = strncmp(argv[4], \"true\", 5) == 0;"
-				<< std::endl;
-		tmpCO
-				<< "    if (reverse != 1 && strncmp(argv[4], \"false\", 6) != 0) {"
-				<< std::endl;
-		tmpCO
-				<< "        fprintf(stderr, \"REVERSE wasn't a valid boolean. Was \\\"%s\\\".\\n\", argv[4]);"
-				<< std::endl;
-		tmpCO << "        return 1;" << std::endl;
-		tmpCO << "    }" << std::endl << std::endl;
-		tmpCO << "    const size_t ep_len = strlen(argv[0]);" << std::endl;
-		tmpCO << "    char *ofp = (char*) malloc(ep_len + 4);" << std::endl;
-		tmpCO << "    strncpy(ofp, argv[0], ep_len);" << std::endl;
-		tmpCO << "    ofp[ep_len] = const_inputs[0] + '0';" << std::endl;
-		tmpCO << "    ofp[ep_len + 1] = const_inputs[1] + '0';" << std::endl;
-		tmpCO << "    ofp[ep_len + 2] = const_inputs[2] + '0';" << std::endl;
-		tmpCO << "    ofp[ep_len + 3] = 0;" << std::endl << std::endl;
-		tmpCO << "    FILE *of = fopen(ofp, \"w\");" << std::endl;
-		tmpCO << "    if (!of) {" << std::endl;
+		tmpCO << "#ifdef _WIN32" << std::endl;
+		tmpCO << "#define EXPORT __declspec(dllexport)" << std::endl;
+		tmpCO << "#else" << std::endl;
+		tmpCO << "#define EXPORT" << std::endl;
+		tmpCO << "#endif" << std::endl << std::endl;
 		tmpCO
-				<< "        fprintf(stderr, \"Failed to open output file \\\"%s\\\".\\n\", ofp);"
+				<< "EXPORT long long int solve_prefix(const unsigned char const_inputs[3], const char reverse, const volatile char *stop) {"
 				<< std::endl;
-		tmpCO << "        return 2;" << std::endl;
-		tmpCO << "    }" << std::endl;
-		tmpCO << "    free(ofp);" << std::endl << std::endl;
 	} else if (RUN_TYPE == EXECUTE) {
+		tmpCO << "int main(const int argc, char *argv[]) {" << std::endl;
 		tmpCO << "    if (argc != " << inpc << " + 1) {" << std::endl;
 		tmpCO << "        fputs(\"This program has " << inpc
 				<< " input instructions, so it requires " << inpc
@@ -1617,15 +3613,6 @@ bool compile_instructions(const std::vector<Instruction> insts,
 		tmpCO << "        const_inputs[i - 1] = (char) input;" << std::endl;
 		tmpCO << "    }" << std::endl << std::endl;
 	}
-	if (simd_enabled) {
-		if (REGISTER_SIZE == REG_SIZE_64) {
-			tmpCO << "    const __m128i cmp_mask = _mm_set_epi64x(1, 1);"
-					<< std::endl;
-		} else {
-			tmpCO << "    const __m128i cmp_mask = _mm_set_epi32(1, 1, 1, 1);"
-					<< std::endl;
-		}
-	}
 	tmpCO << "    " << reg_type << " reg_h[4];" << std::endl;
 
 	const char loop_start[] = "for (char I = 1; I < 10; I++) {";
@@ -1642,32 +3629,22 @@ bool compile_instructions(const std::vector<Instruction> insts,
 			const char regset = std::max('h',
 					static_cast<char>('i' + method_idx - 4));
 			std::string indent;
-			for (size_t i = 0; i < std::max(1, method_idx - 3); i++) {
-				if (!simd_enabled || i < inpc - 1) {
-					indent.append("    ");
-				}
+			for (int j = 0; j < std::max(1, method_idx - 3); j++) {
+				indent.append("    ");
 			}
 
-			if (simd_enabled && method_idx == inpc) {
-				tmpCO << std::endl;
-				if (REGISTER_SIZE == REG_SIZE_64) {
-					tmpCO << indent << "__m128i reg_" << regset << "[4][4];"
-							<< std::endl;
-				} else {
-					tmpCO << indent << "__m128i reg_" << regset << "[2][4];"
-							<< std::endl;
-				}
-				tmpCO << indent << reg_type << " reg_" << regset << "_e[4];"
-						<< std::endl;
-			} else {
-				std::string loop(loop_start);
-				std::replace(loop.begin(), loop.end(), 'I', regset);
-				tmpCO << indent << loop << std::endl;
-
-				indent.append("    ");
-				tmpCO << indent << reg_type << " reg_" << regset << "[4];"
-						<< std::endl;
+			std::string loop(loop_start);
+			std::replace(loop.begin(), loop.end(), 'I', regset);
+			tmpCO << indent << loop << std::endl;
+
+			indent.append("    ");
+			if (method_idx <= STOP_CHECK_DIGITS) {
+				tmpCO << indent << "if (*stop) {" << std::endl;
+				tmpCO << indent << "    return -1;" << std::endl;
+				tmpCO << indent << '}' << std::endl;
 			}
+			tmpCO << indent << reg_type << " reg_" << regset << "[4];"
+					<< std::endl;
 
 			bool regs_used[4] { false };
 			bool regs_checked[4] { false };
@@ -1699,220 +3676,72 @@ bool compile_instructions(const std::vector<Instruction> insts,
 			for (uint16_t j = 0; j < 4; j++) {
 				if (regs_used[j]) {
 					const char prev_regset = regset - 1;
-					if (simd_enabled && RUN_TYPE == SOLVE
-							&& method_idx == inpc) {
-						if (REGISTER_SIZE == REG_SIZE_64) {
-							tmpCO << indent;
-							for (short k = 0; k < 4; k++) {
-								tmpCO << "reg_" << regset << '[' << k << "]["
-										<< j << "] = ";
-							}
-							tmpCO << "_mm_set_epi64x(";
-							for (short k = 0; k < 2; k++) {
-								tmpCO << "reg_" << prev_regset << '[' << j
-										<< ']';
-								if (k < 1) {
-									tmpCO << ", ";
-								}
-							}
-							tmpCO << ");" << std::endl;
-						} else {
-							tmpCO << indent;
-							for (short k = 0; k < 2; k++) {
-								tmpCO << "reg_" << regset << '[' << k << "]["
-										<< j << "] = ";
-							}
-							tmpCO << "_mm_set_epi32(";
-							for (short k = 0; k < 4; k++) {
-								tmpCO << "reg_" << prev_regset << '[' << j
-										<< ']';
-								if (k < 3) {
-									tmpCO << ", ";
-								}
-							}
-							tmpCO << ");" << std::endl;
-						}
-						tmpCO << indent << "reg_" << regset << "_e[" << j;
-						tmpCO << "] = reg_" << prev_regset << '[' << j << "];"
-								<< std::endl;
-					} else {
-						tmpCO << indent << "reg_" << regset << '[' << j;
-						tmpCO << "] = reg_" << prev_regset << '[' << j << "];"
-								<< std::endl;
-					}
+					tmpCO << indent << "reg_" << regset << '[' << j;
+					tmpCO << "] = reg_" << prev_regset << '[' << j << "];"
+							<< std::endl;
 				}
 			}
 		}
 
-		generate_instruction_code(inst, tmpCO, method_idx,
-				simd_enabled && RUN_TYPE == SOLVE && method_idx == inpc);
+		generate_instruction_code(inst, tmpCO, method_idx);
 	}
 
 	tmpCO << std::endl;
 	if (RUN_TYPE == SOLVE) {
-		if (simd_enabled) {
-			tmpCO << "                                            " << reg_type
-					<< " reg_s_3[9];" << std::endl;
-			tmpCO
-					<< "                                            if (reverse) {"
-					<< std::endl;
-			tmpCO
-					<< "                                                reg_s_3[0] = reg_s_e[3];"
-					<< std::endl;
-			if (REGISTER_SIZE == REG_SIZE_64) {
-				for (short i = 3; i >= 0; i--) {
-					for (short j = 0; j < 2; j++) {
-						tmpCO
-								<< "                                                "
-								<< "reg_s_3[" << (8 - (i * 2 + 1 - j))
-								<< "] = _mm_extract_epi64(reg_s[" << i
-								<< "][3], " << j << ");" << std::endl;
-					}
-				}
-			} else {
-				for (short i = 1; i >= 0; i--) {
-					for (short j = 0; j < 4; j++) {
-						tmpCO
-								<< "                                                "
-								<< "reg_s_3[" << (8 - (i * 4 + 3 - j))
-								<< "] = _mm_extract_epi32(reg_s[" << i
-								<< "][3], " << j << ");" << std::endl;
-					}
-				}
-			}
-			tmpCO << "                                            } else {"
-					<< std::endl;
-			if (REGISTER_SIZE == REG_SIZE_64) {
-				for (short i = 0; i < 4; i++) {
-					for (short j = 1; j >= 0; j--) {
-						tmpCO
-								<< "                                                "
-								<< "reg_s_3[" << (1 + i * 2 + 1 - j)
-								<< "] = _mm_extract_epi64(reg_s[" << i
-								<< "][3], " << j << ");" << std::endl;
-					}
-				}
-			} else {
-				for (short i = 0; i < 2; i++) {
-					for (short j = 3; j >= 0; j--) {
-						tmpCO
-								<< "                                                "
-								<< "reg_s_3[" << (1 + i * 4 + 2 - j)
-								<< "] = _mm_extract_epi32(reg_s[" << i
-								<< "][3], " << j << ");" << std::endl;
-					}
-				}
-			}
-			tmpCO
-					<< "                                                reg_s_3[8] = reg_s_e[3];"
-					<< std::endl;
-			tmpCO << "                                            }"
-					<< std::endl << std::endl;
-
-			std::string loop(loop_start);
-			std::replace(loop.begin(), loop.end(), 'I', 's');
-			tmpCO << "                                            " << loop
-					<< std::endl;
-			tmpCO
-					<< "                                                if (reg_s_3[s - 1] == 0) {"
-					<< std::endl;
-		} else {
-			tmpCO
-					<< "                                                if (reg_s[3] == 0) {"
-					<< std::endl;
-		}
-		tmpCO << "                                                    "
-				<< "long long int result = const_inputs[0] * 10000000000000ll + "
-				<< "const_inputs[1] * 1000000000000ll + const_inputs[2] * 100000000000ll;"
-				<< std::endl;
-		tmpCO
-				<< "                                                    if (reverse) {"
-				<< std::endl;
-		tmpCO
-				<< "                                                        result += ";
-		for (short i = 10; i >= 0; i--) {
-			tmpCO << "(10 - " << static_cast<char>('s' - i) << ") * 1";
-			for (short j = 0; j < i; j++) {
-				tmpCO << '0';
-			}
-			tmpCO << "ll";
-			if (i > 0) {
-				tmpCO << " + ";
-			}
-		}
-		tmpCO << ';' << std::endl;
-		tmpCO << "                                                    } else {"
-				<< std::endl;
-		tmpCO
-				<< "                                                        result += ";
-		for (short i = 10; i >= 0; i--) {
-			tmpCO << static_cast<char>('s' - i) << " * 1";
-			for (short j = 0; j < i; j++) {
-				tmpCO << '0';
-			}
-			tmpCO << "ll";
-			if (i > 0) {
-				tmpCO << " + ";
-			}
-		}
-		tmpCO << ';' << std::endl;
-		tmpCO << "                                                    }"
-				<< std::endl;
-		tmpCO << "                                                    "
-				<< "printf(\"Worker %d%d%d found valid number: %lld\\n\", "
-				<< "const_inputs[0], const_inputs[1], const_inputs[2], result);"
-				<< std::endl;
-		tmpCO << "                                                    "
-				<< "fprintf(of, \"%lld\", result);" << std::endl;
-		tmpCO
-				<< "                                                    fclose(of);"
-				<< std::endl;
-		tmpCO << "                                                    return 0;"
-				<< std::endl;
+		const std::string indent(48, ' ');
+		tmpCO << indent << "if (reg_s[3] == 0) {" << std::endl;
+		generate_solver_result(tmpCO, indent + "    ");
+		tmpCO << indent << "    return result;" << std::endl;
 		for (uint8_t i = 12; i > 0; i--) {
 			for (uint8_t j = 0; j < i; j++) {
 				tmpCO << "    ";
 			}
 			tmpCO << '}' << std::endl << std::endl;
 		}
-		tmpCO
-				<< "    printf(\"Worker %d%d%d couldn't find a valid number.\\n\", const_inputs[0], const_inputs[1], const_inputs[2]);"
-				<< std::endl;
-		tmpCO << "    fprintf(of, \"-1\");" << std::endl;
-		tmpCO << "    fclose(of);" << std::endl;
+		tmpCO << "    return -1;" << std::endl;
+		tmpCO << '}' << std::endl;
+
+		if (simd) {
+			size_t inps[15];
+			if (!find_segments(insts, inps)) {
+				return false;
+			}
+
+			uint8_t live_regs[14];
+			find_live_registers(insts, inps, live_regs);
+			for (uint8_t target = 0; target <= SIMD_TARGET; target++) {
+				tmpCO << std::endl;
+				generate_simd_solver(insts, tmpCO, simdTargets[target], inps,
+						live_regs);
+			}
+		}
 	} else if (RUN_TYPE == EXECUTE) {
 		tmpCO
 				<< "    printf(\"The register values after running the program are w="
 				<< reg_format << ", x=" << reg_format << ", y=" << reg_format
 				<< ", z=" << reg_format << ".\\n\", "
 				<< "reg_h[0], reg_h[1], reg_h[2], reg_h[3]);" << std::endl;
+		tmpCO << "    return 0;" << std::endl;
+		tmpCO << '}' << std::endl;
 	}
-	tmpCO << "    return 0;" << std::endl;
-	tmpCO << '}' << std::endl;
-	tmpCO.close();
+	const std::string source = tmpCO.str();
 
 	std::string cmd = "";
-	std::filesystem::path tmpE(tmpDir);
-	tmpE += std::filesystem::path::preferred_separator;
-	tmpE += "tmp";
-	// Always generate .exe files on windows.
-	if (std::filesystem::path::preferred_separator == '\\') {
-		tmpE += ".exe";
-	}
+	const std::filesystem::path tmpE = get_temp_output(tmpDir);
 
 	switch (comp) {
 	case Compiler::GCC:
 		cmd = std::string("gcc -o ").append(tmpE.generic_string()).append(
 				" -O3 ").append(tmpC.generic_string());
-		if (simd_enabled) {
-			cmd.append(" -msse4.1");
+		if (RUN_TYPE == SOLVE) {
+			cmd.append(" -shared -fPIC");
 		}
 		break;
 	case Compiler::CLANG:
 		cmd = std::string("clang -o ").append(tmpE.generic_string()).append(
 				" -O3 ").append(tmpC.generic_string());
-		if (simd_enabled) {
-			cmd.append(" -msse4.1");
+		if (RUN_TYPE == SOLVE) {
+			cmd.append(" -shared -fPIC");
 		}
 		break;
 	case Compiler::CL: {
@@ -1922,6 +3751,9 @@ bool compile_instructions(const std::vector<Instruction> insts,
 		cmd = std::string("cl /Fo: ").append(tmpO.generic_string()).append(
 				" /Fe: ").append(tmpE.generic_string()).append(" /O2 ").append(
 				tmpC.generic_string());
+		if (RUN_TYPE == SOLVE) {
+			cmd.append(" /LD");
+		}
 		break;
 	}
 	default:
@@ -1930,6 +3762,26 @@ bool compile_instructions(const std::vector<Instruction> insts,
 		return false;
 	}
 
+	// The output paths never change, so the command only differs by compiler and flags.
+	const std::filesystem::path cached = get_cache_path(
+			fnv1a_hash(
+					cmd + '\n' + get_compiler_version(comp) + '\n' + source));
+	if (CACHE_COMPILATIONS && std::filesystem::exists(cached)) {
+		std::error_code error;
+		std::filesystem::copy_file(cached, tmpE,
+				std::filesystem::copy_options::overwrite_existing, error);
+		if (!error) {
+			std::cout << "Using cached build " << cached << '.' << std::endl;
+			return true;
+		}
+		std::cerr << "Failed to copy cached build " << cached << ": "
+				<< error.message() << '.' << std::endl;
+	}
+
+	std::ofstream tmpCF(tmpC);
+	tmpCF << source;
+	tmpCF.close();
+
 	std::cout << "Running \"" << cmd << "\"." << std::endl;
 	int status = std::system(cmd.c_str());
 	if (status != 0) {
@@ -1945,9 +3797,89 @@ bool compile_instructions(const std::vector<Instruction> insts,
 		std::cout << std::endl;
 	}
 
+	if (CACHE_COMPILATIONS) {
+		// Copy to a temporary name first, so other processes never load a partial file.
+		std::filesystem::path partial(cached);
+		partial += ".part";
+		std::error_code error;
+		std::filesystem::create_directories(CACHE_DIR, error);
+		if (!error) {
+			std::filesystem::copy_file(tmpE, partial,
+					std::filesystem::copy_options::overwrite_existing, error);
+		}
+		if (!error) {
+			std::filesystem::rename(partial, cached, error);
+		}
+		if (error) {
+			std::cerr << "Failed to cache build " << cached << ": "
+					<< error.message() << '.' << std::endl;
+		}
+	}
+
 	return true;
 }
 
+uint64_t fnv1a_hash(const std::string_view data) {
+	uint64_t hash = 14695981039346656037ull;
+	for (const char c : data) {
+		hash ^= (uint8_t) c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::string get_compiler_version(const Compiler comp) {
+	std::string cmd;
+	switch (comp) {
+	case Compiler::GCC:
+		cmd = "gcc --version";
+		break;
+	case Compiler::CLANG:
+		cmd = "clang --version";
+		break;
+	case Compiler::CL:
+		// cl has no version option, but prints its banner when run without arguments.
+		cmd = "cl";
+		break;
+	default:
+		return "";
+	}
+	cmd.append(" 2>&1");
+
+#ifdef _WIN32
+	FILE *pipe = _popen(cmd.c_str(), "r");
+#else
+	FILE *pipe = popen(cmd.c_str(), "r");
+#endif
+	if (!pipe) {
+		std::cerr << "Failed to run \"" << cmd << "\"." << std::endl;
+		return "";
+	}
+
+	std::string version;
+	char buffer[256];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+		version.append(buffer, read);
+	}
+#ifdef _WIN32
+	_pclose(pipe);
+#else
+	pclose(pipe);
+#endif
+	return version;
+}
+
+std::filesystem::path get_cache_path(const uint64_t key) {
+	std::ostringstream name;
+	name << std::hex << std::setw(16) << std::setfill('0') << key;
+	std::filesystem::path path(CACHE_DIR);
+	path += std::filesystem::path::preferred_separator;
+	path += name.str();
+	path += get_temp_output(CACHE_DIR).extension();
+	return path;
+}
+
 Compiler detect_compiler() {
 	std::cout << "Searching for compiler to use..." << std::endl;
 	std::string mute_str = "";
@@ -1975,167 +3907,90 @@ Compiler detect_compiler() {
 	}
 }
 
-std::optional<bool> detect_simd(const Compiler comp,
-		const std::filesystem::path tmpDir) {
-	if (comp == Compiler::NONE) {
-		std::cerr << "Cannot detect SIMD support without a compiler."
-				<< std::endl;
-		return std::nullopt;
-	}
+#ifdef CPUID_SUPPORTED
+/**
+ * Runs the cpuid instruction for the given leaf, with sub-leaf 0.
+ *
+ * @param leaf	The cpuid leaf to query.
+ * @param info	The array to write eax, ebx, ecx, and edx to.
+ */
+void cpuid(const uint32_t leaf, uint32_t info[4]) {
+#ifdef _MSC_VER
+	int regs[4];
+	__cpuidex(regs, leaf, 0);
+	std::copy(regs, regs + 4, info);
+#else
+	__cpuid_count(leaf, 0, info[0], info[1], info[2], info[3]);
+#endif
+}
 
-	if (std::filesystem::exists(tmpDir)
-			&& !std::filesystem::is_directory(tmpDir)) {
-		std::cerr << std::filesystem::canonical(tmpDir)
-				<< " exists but isn't a directory." << std::endl;
-		return std::nullopt;
-	} else if (!std::filesystem::exists(tmpDir)
-			&& !std::filesystem::create_directories(tmpDir)) {
-		std::cerr << tmpDir << " does not exist and can't be created."
-				<< std::endl;
-		return std::nullopt;
-	}
+/**
+ * Reads the extended control register 0, containing the register states saved by the os.
+ * May only be called if cpuid reports osxsave support.
+ *
+ * @return	The value of xcr0.
+ */
+uint64_t xgetbv() {
+#ifdef _MSC_VER
+	return _xgetbv(0);
+#else
+	// Inline assembly, since the intrinsic requires compiling with -mxsave.
+	uint32_t eax, edx;
+	__asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+	return ((uint64_t) edx << 32) | eax;
+#endif
+}
+#endif
 
-	std::filesystem::path tmpC(tmpDir);
-	tmpC += std::filesystem::path::preferred_separator;
-	tmpC += "sse_detect.c";
+uint8_t detect_simd_targets() {
+	uint8_t targets = 0;
+#ifdef CPUID_SUPPORTED
+	uint32_t info[4];
+	cpuid(0, info);
+	const uint32_t max_leaf = info[0];
 
-	if (std::filesystem::exists(tmpC)
-			&& !std::filesystem::is_regular_file(tmpC)) {
-		std::cerr << tmpC << " exists but isn't a file." << std::endl;
-		return std::nullopt;
-	} else if (std::filesystem::exists(tmpC)
-			&& !std::filesystem::remove(tmpC)) {
-		std::cerr << "Failed to remove " << tmpC << '.' << std::endl;
-		return std::nullopt;
+	cpuid(1, info);
+	if (info[2] & (1 << 19)) {
+		targets |= 1 << SIMD_SSE4_1;
 	}
 
-	std::ofstream tmpCO(tmpC);
-	tmpCO << "/**" << std::endl;
-	tmpCO << " * This source file was automatically generated" << std::endl;
-	tmpCO
-			<< " * by a Advent of Code(https://adventofcode.com/) year 2021 day 24 solution."
-			<< std::endl;
-	tmpCO << " *" << std::endl;
-	tmpCO << " * It will be overridden and re-compiled on the next run,"
-			<< std::endl;
-	tmpCO
-			<< " * so manually modifying it is unlikely to yield the desired results."
-			<< std::endl;
-	tmpCO << " */" << std::endl << std::endl;
-	tmpCO << "#include <stdio.h>" << std::endl;
-	tmpCO << "#include <immintrin.h>" << std::endl << std::endl;
-	tmpCO << "#ifndef _XCR_XFEATURE_ENABLED_MASK" << std::endl;
-	tmpCO << "#define _XCR_XFEATURE_ENABLED_MASK 0" << std::endl;
-	tmpCO << "#endif" << std::endl << std::endl;
-	tmpCO << "#define XSTATE_SSE 0x2" << std::endl;
-	tmpCO << "#ifdef _WIN32" << std::endl;
-	tmpCO << "#define cpuid(info, x)    __cpuidex(info, x, 0)" << std::endl;
-	tmpCO << "#else" << std::endl;
-	tmpCO << "#include <cpuid.h>" << std::endl;
-	tmpCO << "#include <xsaveintrin.h>" << std::endl << std::endl;
-	tmpCO << "void cpuid(int info[4], int x) {" << std::endl;
-	tmpCO << "    __cpuid_count(x, 0, info[0], info[1], info[2], info[3]);"
-			<< std::endl;
-	tmpCO << "}" << std::endl;
-	tmpCO << "#endif" << std::endl << std::endl;
-	tmpCO << "int main(int argc, char **argv) {" << std::endl;
-	tmpCO << "    int cpuInfo[4];" << std::endl;
-	tmpCO << "    cpuid(cpuInfo, 1);" << std::endl << std::endl;
-	tmpCO << "    int cpuSSE4_1 = cpuInfo[2] & ((int) 1 << 19);" << std::endl;
-	tmpCO << "    int osXSAVE = cpuInfo[2] & ((int) 1 << 27);" << std::endl;
-	tmpCO << "    if (osXSAVE && cpuSSE4_1) {" << std::endl;
-	tmpCO
-			<< "        unsigned long long xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);"
-			<< std::endl;
-	tmpCO << "        int osSSE = (xcrFeatureMask & XSTATE_SSE) == XSTATE_SSE;"
-			<< std::endl;
-	tmpCO << "        if (osSSE && cpuSSE4_1) {" << std::endl;
-	tmpCO
-			<< "            // Run a very basic SSE test using SSE4.1 instructions."
-			<< std::endl;
-	tmpCO << "            const int sse_testi = (int) (rand() * 1000.0);"
-			<< std::endl;
-	tmpCO << "            __m128i sse_test = _mm_set_epi32(sse_testi, 0, 0, 0);"
-			<< std::endl;
-	tmpCO
-			<< "            sse_test = _mm_mullo_epi32(sse_test, _mm_set_epi32(7, 0, 0, 0));"
-			<< std::endl;
-	tmpCO
-			<< "            if (_mm_extract_epi32(sse_test, 3) != sse_testi * 7) {"
-			<< std::endl;
-	tmpCO << "                puts(\"SSE test failed.\");" << std::endl;
-	tmpCO << "                return 1;" << std::endl;
-	tmpCO << "            }" << std::endl;
-	tmpCO << "            puts(\"SSE4.1 supported.\");" << std::endl;
-	tmpCO << "            return 0;" << std::endl;
-	tmpCO << "        }" << std::endl;
-	tmpCO << "    }" << std::endl << std::endl;
-	tmpCO << "    puts(\"SSE4.1 not supported.\");" << std::endl;
-	tmpCO << "    return 1;" << std::endl;
-	tmpCO << "}" << std::endl;
-	tmpCO.close();
+	// The os has to save the ymm and zmm registers on context switches.
+	const bool osxsave = info[2] & (1 << 27);
+	const bool avx = info[2] & (1 << 28);
+	const uint64_t xcr0 = osxsave ? xgetbv() : 0;
+	if (max_leaf >= 7 && avx && (xcr0 & 0x6) == 0x6) {
+		cpuid(7, info);
+		if (info[1] & (1 << 5)) {
+			targets |= 1 << SIMD_AVX2;
+		}
 
-	std::string cmd = "";
+		// AVX-512F and AVX-512DQ, with the opmask and zmm state enabled.
+		if ((info[1] & (1 << 16)) && (info[1] & (1 << 17))
+				&& (xcr0 & 0xE6) == 0xE6) {
+			targets |= 1 << SIMD_AVX512;
+		}
+	}
+#endif
+	return targets;
+}
+
+std::filesystem::path get_temp_output(const std::filesystem::path tmpDir) {
 	std::filesystem::path tmpE(tmpDir);
 	tmpE += std::filesystem::path::preferred_separator;
 	tmpE += "tmp";
-	// Always generate .exe files on windows.
-	if (std::filesystem::path::preferred_separator == '\\') {
+	if (RUN_TYPE == SOLVE) {
+#if defined(_WIN32)
+		tmpE += ".dll";
+#elif defined(__APPLE__)
+		tmpE += ".dylib";
+#else
+		tmpE += ".so";
+#endif
+	} else if (std::filesystem::path::preferred_separator == '\\') {
+		// Always generate .exe files on windows.
 		tmpE += ".exe";
 	}
-
-	switch (comp) {
-	case Compiler::GCC:
-		cmd = std::string("gcc -o ").append(tmpE.generic_string()).append(
-				" -O3 ").append(tmpC.generic_string()).append(
-				" -mxsave -msse4.1");
-		break;
-	case Compiler::CLANG:
-		cmd = std::string("clang -o ").append(tmpE.generic_string()).append(
-				" -O3 ").append(tmpC.generic_string()).append(
-				" -mxsave -msse4.1");
-		break;
-	case Compiler::CL: {
-		std::filesystem::path tmpO(tmpDir);
-		tmpO += std::filesystem::path::preferred_separator;
-		tmpO += "tmp.o";
-		cmd = std::string("cl /Fo: ").append(tmpO.generic_string()).append(
-				" /Fe: ").append(tmpE.generic_string()).append(" /O2 ").append(
-				tmpC.generic_string());
-		break;
-	}
-	default:
-		std::cerr << "Received unknown compiler value " << comp << '!'
-				<< std::endl;
-		return std::nullopt;
-	}
-
-	std::cout << "Running \"" << cmd << "\"." << std::endl;
-	int status = std::system(cmd.c_str());
-	if (status != 0) {
-		std::cout << "Failed to compile SSE test. Disabling SIMD mode."
-				<< std::endl;
-		if (DELETE_COMPILATION_FILES) {
-			std::cout << "Deleting sse_test source file." << std::endl;
-			std::filesystem::remove(tmpC);
-		}
-		return std::optional<bool> { false };
-	}
-
-	cmd = std::string(tmpE.generic_string());
-	std::cout << "Running \"" << cmd << "\"." << std::endl;
-	status = std::system(cmd.c_str());
-	if (status != 0) {
-		std::cout << "SSE test failed. Disabling SIMD mode." << std::endl;
-	} else {
-		std::cout << "SIMD support detected." << std::endl;
-	}
-	if (DELETE_COMPILATION_FILES) {
-		std::cout << "Deleting sse_test source file." << std::endl;
-		std::filesystem::remove(tmpC);
-	}
-
-	return std::optional<bool> { status == 0 };
+	return tmpE;
 }
 
 std::optional<std::filesystem::path> create_temp_lib(
@@ -2153,19 +4008,22 @@ std::optional<std::filesystem::path> create_temp_lib(
 		return std::nullopt;
 	}
 
-	if (!compile_instructions(instructions, tmpDir, compiler)) {
-		return std::nullopt;
+	const bool simd = RUN_TYPE == SOLVE && SIMD_MODE != SIMD_DISABLED;
+	if (!compile_instructions(instructions, tmpDir, compiler, simd)) {
+		if (!simd || SIMD_MODE != SIMD_AUTO) {
+			return std::nullopt;
+		}
+
+		// Old compilers may not support all SIMD targets.
+		std::cerr << "Building the SIMD solvers failed. Retrying without SIMD."
+				<< std::endl;
+		if (!compile_instructions(instructions, tmpDir, compiler, false)) {
+			return std::nullopt;
+		}
 	}
 
-	std::filesystem::path tmpE(tmpDir);
-	tmpE += std::filesystem::path::preferred_separator;
-	tmpE += "tmp";
+	const std::filesystem::path tmpE = get_temp_output(tmpDir);
 	if (!std::filesystem::exists(tmpE)) {
-		std::filesystem::path tmpExe(tmpE);
-		tmpExe += ".exe";
-		if (std::filesystem::exists(tmpExe)) {
-			return std::optional<std::filesystem::path> { tmpExe };
-		}
 		std::cerr << "Make didn't create library " << tmpE << '.' << std::endl;
 		return std::nullopt;
 	}
@@ -2176,6 +4034,13 @@ std::optional<std::filesystem::path> create_temp_lib(
 bool delete_temp(const std::filesystem::path tmpDir,
 		const std::filesystem::path tmpExe) {
 	std::filesystem::remove(tmpExe);
+	// Remove the import library created by MSVC.
+	for (const char *name : { "tmp.lib", "tmp.exp" }) {
+		std::filesystem::path tmpF(tmpDir);
+		tmpF += std::filesystem::path::preferred_separator;
+		tmpF += name;
+		std::filesystem::remove(tmpF);
+	}
 	std::filesystem::path tmpO(tmpDir);
 	tmpO += std::filesystem::path::preferred_separator;
 	tmpO += "tmp.o";
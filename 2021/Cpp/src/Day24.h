@@ -9,12 +9,17 @@
 #define DAY24_H_
 
 #include "Main.h"
+#include "ThreadPool.h"
 #include <array>
 #include <atomic>
+#include <condition_variable>
 #include <filesystem>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <optional>
+#include <string_view>
+#include <unordered_set>
 #include <vector>
 
 /**
@@ -119,6 +124,92 @@ struct Instruction {
 	Instruction(InstType t, uint8_t a, bool cb, int32_t b) :
 			type(t), reg_a(a), const_b(cb), in_b(b) {
 	}
+
+	/**
+	 * Checks whether this instruction is the same as the given other instruction.
+	 *
+	 * @param other	The instruction to compare this instruction with.
+	 * @return	True if both instructions have the same type, registers, and constant.
+	 */
+	bool operator ==(const Instruction &other) const;
+};
+
+/**
+ * A single value of the static single assignment form of a program, as used by ssa_optimize.
+ * Since the programs don't contain any branches, every value is defined by exactly one operation,
+ * and the values are stored in the order in which they are calculated.
+ */
+struct SSAValue {
+	/**
+	 * The operation calculating this value.
+	 * INP for input digits, SET for constants, and NOP for values that were removed.
+	 */
+	InstType type;
+	/**
+	 * The index of the input digit for INP values, or the value of SET values.
+	 */
+	int64_t constant;
+	/**
+	 * The index of the primary input value of the operation. -1 if it doesn't have one.
+	 */
+	int32_t a;
+	/**
+	 * The index of the secondary input value of the operation. -1 if it doesn't have one.
+	 */
+	int32_t b;
+	/**
+	 * The register the original instruction wrote this value to.
+	 * Used as the preferred register when converting the program back to instructions.
+	 */
+	uint8_t home;
+	/**
+	 * The smallest value this can have, as found by ssa_fold_ranges.
+	 */
+	int64_t min;
+	/**
+	 * The largest value this can have, as found by ssa_fold_ranges.
+	 */
+	int64_t max;
+
+	/**
+	 * Creates a new SSA value with an unknown range.
+	 *
+	 * @param t	The operation calculating the value.
+	 * @param c	The input index or constant value.
+	 * @param a	The index of the primary input value.
+	 * @param b	The index of the secondary input value.
+	 * @param h	The register the value was originally written to.
+	 */
+	SSAValue(const InstType t, const int64_t c, const int32_t a,
+			const int32_t b, const uint8_t h);
+};
+
+/**
+ * A program in static single assignment form.
+ */
+struct SSAProgram {
+	/**
+	 * All values calculated by the program, in the order in which they are calculated.
+	 */
+	std::vector<SSAValue> values;
+	/**
+	 * The indices of the values held by each register at the end of the program.
+	 */
+	int32_t outputs[4];
+};
+
+/**
+ * A single optimization pass run by optimize_instructions.
+ */
+struct OptimizationPass {
+	/**
+	 * The name of the pass, used in reports and as the name of its phase.
+	 */
+	const char *name;
+	/**
+	 * The function running the pass.
+	 */
+	std::vector<Instruction> (*run)(const std::vector<Instruction>&);
 };
 
 /**
@@ -161,9 +252,412 @@ static const char *compilerNames[] {
 };
 
 /**
- * A function object representing a dynamic function executing a part of the input.
+ * The vector instruction sets the compiled solver can be generated for.
+ * Ordered by vector width, so later targets are expected to be faster.
+ */
+enum SIMDTarget {
+	/**
+	 * 128 bit vectors, using SSE4.1 for 32 bit multiplications and 64 bit comparisons.
+	 */
+	SIMD_SSE4_1,
+	/**
+	 * 256 bit vectors, using AVX2.
+	 */
+	SIMD_AVX2,
+	/**
+	 * 512 bit vectors, using AVX-512F, and AVX-512DQ for 64 bit multiplications.
+	 */
+	SIMD_AVX512
+};
+
+/**
+ * The information required to generate the code for a single SIMD target.
+ */
+struct SIMDInfo {
+	/**
+	 * The name of the target, used as the suffix of its solver function.
+	 */
+	const char *name;
+	/**
+	 * The gcc and clang target attribute enabling the instruction set for a single function.
+	 */
+	const char *target;
+	/**
+	 * The integer vector type of the instruction set.
+	 */
+	const char *type;
+	/**
+	 * The prefix of the intrinsics functions of the instruction set.
+	 */
+	const char *prefix;
+	/**
+	 * The suffix of intrinsics working on the whole vector, like loadu and and.
+	 */
+	const char *si;
+	/**
+	 * The function setting all 64 bit lanes of a vector to the same value.
+	 */
+	const char *set1_64;
+	/**
+	 * The size of a vector, in bits.
+	 */
+	uint16_t bits;
+};
+
+/**
+ * The code generation information for each SIMD target, indexed by SIMDTarget.
  */
-typedef std::function<void(const long long int[4], long long int*, const char)> dynfunc;
+static const SIMDInfo simdTargets[] { { "sse4_1", "sse4.1", "__m128i", "_mm",
+		"si128", "_mm_set1_epi64x", 128 }, { "avx2", "avx2", "__m256i",
+		"_mm256", "si256", "_mm256_set1_epi64x", 256 }, { "avx512",
+		"avx512f,avx512dq", "__m512i", "_mm512", "si512", "_mm512_set1_epi64",
+		512 } };
+
+/**
+ * A macro to automatically generate an enum and a lookup table for the bytecode operations.
+ * Operations ending in _R use register b as their secondary input, ones ending in _I the constant.
+ */
+#define BytecodeTypes \
+	/** \
+	 * Reads the next input digit and writes it to register a. \
+	 */ \
+	Entry(INP), \
+	Entry(ADD_R), \
+	Entry(ADD_I), \
+	Entry(SUB_R), \
+	Entry(MUL_R), \
+	Entry(MUL_I), \
+	Entry(DIV_R), \
+	Entry(DIV_I), \
+	Entry(MOD_R), \
+	Entry(MOD_I), \
+	Entry(EQL_R), \
+	Entry(EQL_I), \
+	Entry(NEQ_R), \
+	Entry(NEQ_I), \
+	Entry(SET_R), \
+	Entry(SET_I), \
+	/** \
+	 * Sets register a to the sum of register b and the constant. \
+	 * Replaces "SET a b; ADD a c". \
+	 */ \
+	Entry(SET_ADD), \
+	/** \
+	 * Sets register a to the product of register b and the constant. \
+	 * Replaces "SET a b; MUL a c" and "SET a c; MUL a b". \
+	 */ \
+	Entry(SET_MUL), \
+	/** \
+	 * Sets register a to the remainder of register b divided by the constant. \
+	 * Replaces "SET a b; MOD a c", and "MUL a 0; ADD a b; MOD a c" in unoptimized programs. \
+	 */ \
+	Entry(SET_MOD), \
+	/** \
+	 * Multiplies register a by register b, and adds the constant. \
+	 * Replaces "MUL a b; ADD a c". \
+	 */ \
+	Entry(MUL_ADD), \
+	/** \
+	 * Writes the registers to the output and returns. \
+	 */ \
+	Entry(END)
+
+/**
+ * An enum representing the operations of the pre-decoded bytecode interpreter.
+ */
+enum class BytecodeType : uint8_t {
+#define Entry(a) a
+	BytecodeTypes
+#undef Entry
+};
+
+/**
+ * A single pre-decoded bytecode operation.
+ * Created from one or more instructions by compile_bytecode.
+ */
+struct BytecodeOp {
+	/**
+	 * The operation to execute.
+	 */
+	BytecodeType type;
+	/**
+	 * The register this operation writes to.
+	 */
+	uint8_t reg_a;
+	/**
+	 * The register used as the secondary input, if the operation uses one.
+	 */
+	uint8_t reg_b;
+	/**
+	 * The constant used by the operation, if it uses one.
+	 */
+	int64_t value;
+};
+
+/**
+ * The state of the search for a valid number at the start of a segment of the input.
+ */
+struct SearchState {
+	/**
+	 * The index of the segment that is about to be executed.
+	 */
+	uint8_t segment;
+	/**
+	 * The values of the registers used by the rest of the program.
+	 * Registers that are overridden before being read are always 0.
+	 */
+	long long int regs[4];
+
+	/**
+	 * Creates a new search state, clearing all registers that aren't live.
+	 *
+	 * @param seg	The index of the segment that is about to be executed.
+	 * @param vals	The current register values.
+	 * @param live	A bit mask of the registers read by the rest of the program.
+	 */
+	SearchState(const uint8_t seg, const long long int vals[4],
+			const uint8_t live);
+
+	/**
+	 * Checks whether this state is the same as the given other state.
+	 *
+	 * @param other	The state to compare this state with.
+	 * @return	True if both states are for the same segment and have the same registers.
+	 */
+	bool operator ==(const SearchState &other) const;
+};
+
+namespace std {
+template<>
+struct hash<SearchState> {
+	/**
+	 * Creates a hash for the given search state.
+	 *
+	 * @param to_hash	The state for which to calculate the hash.
+	 * @return The hash value for the given state.
+	 */
+	size_t operator ()(const SearchState &to_hash) const;
+};
+}
+
+/**
+ * A thread safe set of search states from which no valid number can be reached.
+ * Split into shards with their own lock, so threads rarely wait for each other.
+ */
+class DeadStateSet {
+private:
+	/**
+	 * The number of independently locked shards.
+	 */
+	static const size_t SHARDS = 64;
+
+	/**
+	 * A part of the set, containing the states whose hash maps to it.
+	 */
+	struct shard {
+		/**
+		 * The mutex protecting the states of this shard.
+		 */
+		std::mutex mutex;
+
+		/**
+		 * The dead states in this shard.
+		 */
+		std::unordered_set<SearchState> states;
+	};
+
+	/**
+	 * The shards of this set.
+	 */
+	std::array<shard, SHARDS> shards;
+
+	/**
+	 * Gets the shard the given state belongs to.
+	 *
+	 * @param state	The state to get the shard for.
+	 * @return	The shard that contains the state, if it is in this set.
+	 */
+	shard& get_shard(const SearchState &state);
+
+public:
+	/**
+	 * Checks whether the given state is known to be dead.
+	 *
+	 * @param state	The state to check.
+	 * @return	True if the state was added to this set.
+	 */
+	bool contains(const SearchState &state);
+
+	/**
+	 * Marks the given state as dead.
+	 *
+	 * @param state	The state from which no valid number can be reached.
+	 */
+	void insert(const SearchState &state);
+
+	/**
+	 * Counts the dead states in this set.
+	 *
+	 * @return	The number of states in this set.
+	 */
+	size_t size();
+};
+
+/**
+ * The shared state of a search over all 729 three digit prefixes, as run by find_first_prefix.
+ * Prefixes are indexed in search order, so a valid number for a lower index always wins.
+ */
+struct PrefixSearch {
+	/**
+	 * The number of possible three digit prefixes without zeros.
+	 */
+	static const uint16_t PREFIXES = 729;
+
+	/**
+	 * The result of each prefix.
+	 * -2 while it wasn't checked yet, -1 if it doesn't have a valid number.
+	 */
+	std::array<std::atomic<int64_t>, PREFIXES> results;
+
+	/**
+	 * The stop flag of each prefix.
+	 * Set once a valid number was found for an earlier prefix.
+	 */
+	std::array<std::atomic<bool>, PREFIXES> stops;
+
+	/**
+	 * The search order index of the next prefix to be claimed by a worker.
+	 */
+	std::atomic<uint16_t> next;
+
+	/**
+	 * The mutex used to wait for prefix results.
+	 */
+	std::mutex mutex;
+
+	/**
+	 * The condition variable notified whenever a prefix finishes.
+	 */
+	std::condition_variable finished;
+
+	/**
+	 * Creates a new prefix search with no checked prefixes.
+	 */
+	PrefixSearch();
+};
+
+/**
+ * A pointer to a solve_prefix function of a solver library created by create_temp_lib.
+ * Takes the first three digits, whether to search for the highest number, and a flag to stop the search,
+ * and returns the first valid number starting with those digits, or -1.
+ * Also returns -1 soon after the stop flag is set to a non zero value.
+ */
+typedef long long int (*solverfunc)(const unsigned char[3], const char,
+		const volatile char*);
+
+/**
+ * A shared library created by create_temp_lib, loaded into this process.
+ */
+class CompiledSolver {
+private:
+	/**
+	 * The handle of the loaded library.
+	 * NULL if it couldn't be loaded.
+	 */
+	void *handle;
+
+public:
+	/**
+	 * Loads the given shared library.
+	 * Prints an error if this isn't possible.
+	 *
+	 * @param lib	The path of the library to load.
+	 */
+	CompiledSolver(const std::filesystem::path lib);
+
+	/**
+	 * Unloads the library.
+	 * Invalidates all functions obtained from this object.
+	 */
+	virtual ~CompiledSolver();
+
+	CompiledSolver(const CompiledSolver &solver) = delete;
+
+	CompiledSolver& operator=(const CompiledSolver &solver) = delete;
+
+	/**
+	 * Checks whether the library was successfully loaded.
+	 *
+	 * @return	True if functions can be obtained from this object.
+	 */
+	bool is_valid() const;
+
+	/**
+	 * Gets the solver function with the given name from the library.
+	 *
+	 * @param name	The name of the function, like solve_prefix or solve_prefix_avx2.
+	 * @return	The function searching for the first valid number with a given prefix,
+	 * 			or NULL if the library doesn't export it.
+	 */
+	solverfunc get_function(const std::string &name) const;
+};
+
+/**
+ * A pointer to a function generated at runtime, executing a part of the input.
+ * Takes the same arguments as run_program, except for the instructions and the number of inputs.
+ */
+typedef void (*jitfunc)(const long long int[4], long long int*, const char[]);
+
+/**
+ * A block of executable memory containing x86-64 machine code generated by jit_compile.
+ */
+class JitCode {
+private:
+	/**
+	 * The executable memory containing the machine code.
+	 * NULL if the code couldn't be made executable.
+	 */
+	uint8_t *memory;
+
+	/**
+	 * The size of the executable memory, in bytes.
+	 */
+	size_t size;
+
+public:
+	/**
+	 * Copies the given machine code into newly allocated executable memory.
+	 * Prints an error if this isn't possible on the current platform.
+	 *
+	 * @param code	The machine code to make executable.
+	 */
+	JitCode(const std::vector<uint8_t> &code);
+
+	/**
+	 * Frees the executable memory.
+	 * Invalidates all functions obtained from this object.
+	 */
+	virtual ~JitCode();
+
+	JitCode(const JitCode &code) = delete;
+
+	JitCode& operator=(const JitCode &code) = delete;
+
+	/**
+	 * Checks whether the machine code was successfully made executable.
+	 *
+	 * @return	True if functions can be obtained from this object.
+	 */
+	bool is_valid() const;
+
+	/**
+	 * Gets the function starting at the given offset in the machine code.
+	 *
+	 * @param offset	The offset of the function, as returned by jit_compile.
+	 * @return	A pointer to the executable function.
+	 */
+	jitfunc get_function(const size_t offset) const;
+};
 
 /**
  * Writes a string representation of the given instruction to the given output stream.
@@ -203,6 +697,73 @@ std::ostream& operator <<(std::ostream &stream, const Compiler &comp);
 void print_instructions(const char *state,
 		const std::vector<Instruction> &insts, std::ostream &stream);
 
+/**
+ * Reads the value of a single day specific setting given using --option, if it was given.
+ * The value is stored as the index of the matching name.
+ * Prints an error and keeps the current value if the given value doesn't match any name.
+ *
+ * @tparam T		The type of the setting. Has to be constructible from an index.
+ * @tparam N		The number of possible values.
+ * @param key		The name of the setting.
+ * @param names		The names of the possible values, indexed by the value they represent.
+ * @param setting	The setting to store the value in.
+ */
+template<typename T, size_t N>
+void read_setting(const std::string_view key,
+		const std::array<std::string_view, N> &names, T &setting);
+
+/**
+ * Reads all day 24 settings given using --option, and applies them.
+ * Settings that weren't given keep their previous values.
+ */
+void read_settings();
+
+/**
+ * Runs all optimization passes on the given instructions, until an iteration doesn't change them anymore.
+ * Then reorders them using delay_input.
+ * Prints the instructions after each pass, or after the last one, depending on PRINT_INSTRUCTIONS,
+ * and the number of instructions and time after each pass if REPORT_PASSES is set.
+ *
+ * @param insts	The instructions to optimize.
+ * @return	The optimized instructions.
+ */
+std::vector<Instruction> optimize_instructions(
+		const std::vector<Instruction> &insts);
+
+/**
+ * Compares the results of the given optimized program to those of the original program,
+ * for the given number of random inputs using run_program_batch.
+ * Only z is compared when solving, and all registers otherwise.
+ * Prints the first mismatch, and the total number of mismatches, if there are any.
+ *
+ * @param original	The instructions of the original program.
+ * @param optimized	The instructions of the optimized program.
+ * @param count		The number of random inputs to compare the programs with.
+ * @return	True if the programs returned the same results for all inputs.
+ */
+bool verify_optimization(const std::vector<Instruction> &original,
+		const std::vector<Instruction> &optimized, const size_t count);
+
+/**
+ * Checks whether the given program can be executed.
+ * Prints an error if it contains a division by zero,
+ * or doesn't have 14 input instructions when solving.
+ *
+ * @param insts	The instructions to check.
+ * @return	True if the program is valid.
+ */
+bool check_instructions(const std::vector<Instruction> &insts);
+
+/**
+ * Solves a single prefix with every combination of EXEC_MODE, OPTIMIZE, SEARCH_MODE,
+ * SIMD_MODE, and REGISTER_SIZE that affects the search, and prints a table comparing their times.
+ * All combinations search the prefix of the same valid number, so they all do the same amount of work.
+ * The settings are restored afterwards.
+ *
+ * @param insts	The unoptimized instructions to run.
+ */
+void sweep_configurations(const std::vector<Instruction> &insts);
+
 /**
  * Optimizes the given program to make it contain fewer instructions.
  * This is done by replacing all sets of instructions that do not use anything
@@ -250,6 +811,88 @@ std::vector<Instruction> delay_input(const std::vector<Instruction> &insts);
  */
 std::vector<Instruction> merge_insts(const std::vector<Instruction> &insts);
 
+/**
+ * Converts the given instructions to static single assignment form.
+ * Register copies and constants are resolved while converting,
+ * so the resulting program only contains values that are actually calculated.
+ *
+ * @param insts	The instructions to convert.
+ * @return	The program in static single assignment form.
+ */
+SSAProgram to_ssa(const std::vector<Instruction> &insts);
+
+/**
+ * Sets the range of the given value.
+ * If the absolute value of either bound reaches RANGE_LIMIT the range is set to the full 64 bit range instead,
+ * which is treated as unknown.
+ *
+ * @param value	The value to set the range of.
+ * @param min	The smallest possible value.
+ * @param max	The largest possible value.
+ */
+void ssa_set_range(SSAValue &value, const int64_t min, const int64_t max);
+
+/**
+ * Calculates the range of possible values of the given operation from the ranges of its inputs.
+ *
+ * @param values	All values of the program. The ranges of the inputs have to be calculated already.
+ * @param value		The value to calculate the range of.
+ */
+void ssa_calculate_range(const std::vector<SSAValue> &values,
+		SSAValue &value);
+
+/**
+ * Calculates the range of possible values of each value, and simplifies the program using them.
+ * Values with a single possible value are replaced by constants,
+ * and operations that can't change their primary input, like MOD x 26 when x is in 0..25,
+ * are replaced by that input.
+ * Comparisons of values with disjoint ranges are replaced by constants as well.
+ *
+ * @param program	The program to simplify.
+ * @return	True if the program was changed.
+ */
+bool ssa_fold_ranges(SSAProgram &program);
+
+/**
+ * Replaces values that are calculated the same way as a previous value by that previous value.
+ *
+ * @param program	The program to simplify.
+ * @return	True if the program was changed.
+ */
+bool ssa_eliminate_common(SSAProgram &program);
+
+/**
+ * Removes values that don't affect the result of the program.
+ * Input values are never removed, since later inputs would read the wrong digits otherwise.
+ *
+ * @param program	The program to simplify.
+ * @return	True if the program was changed.
+ */
+bool ssa_eliminate_dead(SSAProgram &program);
+
+/**
+ * Converts the given program back to instructions, assigning the values to the four registers.
+ * Results are preferably written to the register they are expected in at the end of the program.
+ *
+ * @param program	The program to convert.
+ * @param keep_home	Whether other values should be written to the register they were originally written to,
+ * 					even if that requires a move. Otherwise they override the input they are calculated from.
+ * @return	The converted instructions, or nothing if the values couldn't be assigned to the registers.
+ */
+std::optional<std::vector<Instruction>> from_ssa(const SSAProgram &program,
+		const bool keep_home);
+
+/**
+ * Optimizes the given instructions by converting them to static single assignment form,
+ * running ssa_fold_ranges, ssa_eliminate_common, and ssa_eliminate_dead until none of them changes the program,
+ * and converting the result back to instructions.
+ *
+ * @param insts	The instructions to optimize.
+ * @return	The optimized instructions, or the given instructions if that didn't make them shorter.
+ * 			Also returns the given instructions if the values can't be assigned to four registers.
+ */
+std::vector<Instruction> ssa_optimize(const std::vector<Instruction> &insts);
+
 /**
  * Executes the given set of instructions with the given input.
  *
@@ -265,97 +908,354 @@ void run_program(const Instruction instsv[], const size_t instsc,
 		const size_t inpc);
 
 /**
- * The function to be run in separate threads to search for the first valid number.
- * Sets result to the first valid number found, or -1 if none was found.
+ * Executes the given set of instructions with many inputs at once, like run_program.
+ * The registers are stored as one array per register, with one value per execution,
+ * so every instruction is run for a block of executions in a single vectorizable loop.
  *
- * @param funcs		The functions executing the individual segments of the input.
- * @param digits	The starting digits for the numbers to check.
- * @param result	The pointer to write the first found number to.
- * @param stop		An atomic bool to be set to true to stop this thread.
- * @param highest	If true this method looks for the highest valid number, otherwise the lowest.
+ * @param instsv	The instructions to execute.
+ * @param instsc	The number of instructions in instsv.
+ * @param inpv		The input digits of all executions, inpc digits per execution.
+ * @param inpc		The number of input digits of each execution.
+ * @param count		The number of executions.
+ * @return	The register values after each execution, in the order of the inputs.
+ */
+std::vector<std::array<long long int, 4>> run_program_batch(
+		const Instruction instsv[], const size_t instsc, const char inpv[],
+		const size_t inpc, const size_t count);
+
+/**
+ * Checks whether jit_compile can generate machine code for the current platform.
+ * Currently only x86-64 systems with mmap are supported.
+ *
+ * @return	True if instructions can be compiled to machine code at runtime.
+ */
+bool jit_supported();
+
+/**
+ * Translates the given instructions to a x86-64 machine code function, and appends it to the given code.
+ * The generated function behaves like run_program, using 64 bit registers,
+ * except that it doesn't check the number of input digits.
+ * The ALU registers are kept in r8 to r11 for the entire function.
+ *
+ * @param instsv	The instructions to translate.
+ * @param instsc	The number of instructions in instsv.
+ * @param code		The machine code to append the new function to.
+ * @return	The offset of the new function in the machine code.
+ */
+size_t jit_compile(const Instruction instsv[], const size_t instsc,
+		std::vector<uint8_t> &code);
+
+/**
+ * Translates the given instructions to bytecode for run_bytecode, and appends it to the given bytecode.
+ * Common sequences of instructions are fused into single superinstructions,
+ * and the constant and register variants of each operation are split,
+ * so the interpreter never has to check what kind of input an operation uses.
+ *
+ * @param instsv	The instructions to translate.
+ * @param instsc	The number of instructions in instsv.
+ * @param ops		The bytecode to append the new program to.
+ * @return	The offset of the new program in the bytecode.
+ */
+size_t compile_bytecode(const Instruction instsv[], const size_t instsc,
+		std::vector<BytecodeOp> &ops);
+
+/**
+ * Executes the given bytecode program with the given input.
+ * Uses computed goto dispatch when compiled with gcc or clang.
+ * Doesn't check the number of input digits.
+ *
+ * @param ops		The bytecode program to execute. Has to end with an END operation.
+ * @param reg_vals	The initial register values.
+ * @param reg		The registers to write the result to.
+ * @param inpv		The input digits to use for input operations.
+ */
+void run_bytecode(const BytecodeOp ops[], const long long int reg_vals[4],
+		long long int *reg, const char inpv[]);
+
+/**
+ * Finds the input instructions that split the given program into one segment per input digit.
+ * Prints an error if the program doesn't have exactly 14 input instructions.
+ *
+ * @param insts	The instructions to split.
+ * @param inps	The array to write the start indices of the segments to, followed by the program length.
+ * @return	True if the program has 14 input instructions.
  */
-void find_first_runner_interpreted(const dynfunc funcs[14],
-		const std::array<uint8_t, 3> digits, std::atomic<int64_t> *result,
+bool find_segments(const std::vector<Instruction> &insts, size_t inps[15]);
+
+/**
+ * Calculates which registers are read before being overridden, starting from the input instruction of each segment.
+ * Only z is used after the last segment.
+ *
+ * @param insts		The instructions of the program.
+ * @param inps		The start indices of the segments, as found by find_segments.
+ * @param live_regs	The array to write a bit mask of the live registers for each segment to.
+ * 					Bit 0 is set if w is live, bit 1 for x, and so on.
+ */
+void find_live_registers(const std::vector<Instruction> &insts,
+		const size_t inps[15], uint8_t live_regs[14]);
+
+/**
+ * Recursively searches for the first valid suffix for the given state.
+ * States from which no valid number can be reached are added to the given dead state set,
+ * so they are only ever checked once, even by different threads.
+ *
+ * @tparam F			The type of the segment function.
+ * @param run_segment	A function executing a single segment of the input.
+ * @param live_regs		The live registers at the start of each segment, as found by find_live_registers.
+ * @param dead			The states from which no valid number can be reached.
+ * @param segment		The segment to execute next.
+ * @param reg_vals		The register values at the start of the segment.
+ * @param digits		The digits of the current number. The digits from segment onwards are set if one is found.
+ * @param stop			An atomic bool to be set to true to stop the search.
+ * @param highest		If true this method looks for the highest valid suffix, otherwise the lowest.
+ * @return	True if a valid suffix was found.
+ */
+template<typename F>
+bool find_valid_suffix(const F &run_segment, const uint8_t live_regs[14],
+		DeadStateSet &dead, const uint8_t segment,
+		const long long int reg_vals[4], std::array<uint8_t, 14> &digits,
 		std::atomic<bool> *stop, const bool highest);
+
 /**
- * The function to be run in separate threads to search for the first valid number.
- * Sets result to the first valid number found, or -1 if none was found.
+ * Searches for the first valid number starting with the given prefix.
+ * Uses find_valid_suffix to memoize dead states instead of checking every number.
  *
- * @param exe		The executable to be run to check a number segment.
- * @param digits	The starting digits for the numbers to check.
- * @param result	The pointer to write the first found number to.
- * @param highest	If true this method looks for the highest valid number, otherwise the lowest.
+ * @tparam F			The type of the segment function.
+ * @param run_segment	A function executing a single segment of the input.
+ * @param live_regs		The live registers at the start of each segment, as found by find_live_registers.
+ * @param dead			The states from which no valid number can be reached, shared between all threads.
+ * @param digits		The starting digits for the numbers to check.
+ * @param stop			An atomic bool to be set to true to stop this search.
+ * @param highest		If true this method looks for the highest valid number, otherwise the lowest.
+ * @return	The first valid number found, or -1 if none was found.
  */
-void find_first_runner_compiled(const std::filesystem::path exe,
-		const std::array<uint8_t, 3> digits, std::atomic<int64_t> *result,
+template<typename F>
+int64_t find_first_runner_memoized(const F &run_segment,
+		const uint8_t live_regs[14], DeadStateSet *dead,
+		const std::array<uint8_t, 3> digits, std::atomic<bool> *stop,
+		const bool highest);
+
+/**
+ * Searches for the first valid number starting with the given prefix.
+ *
+ * @tparam F			The type of the segment function.
+ * @param run_segment	A function executing a single segment of the input.
+ * 						Takes the segment index, the initial registers, the output registers, and the input digit.
+ * @param digits		The starting digits for the numbers to check.
+ * @param stop			An atomic bool to be set to true to stop this search.
+ * @param highest		If true this method looks for the highest valid number, otherwise the lowest.
+ * @return	The first valid number found, or -1 if none was found.
+ */
+template<typename F>
+int64_t find_first_runner(const F &run_segment,
+		const std::array<uint8_t, 3> digits, std::atomic<bool> *stop,
+		const bool highest);
+
+/**
+ * Searches for the first valid number starting with the given prefix.
+ *
+ * @param solve_prefix	The solve_prefix function of the loaded solver library.
+ * @param digits		The starting digits for the numbers to check.
+ * @param stop			A flag to stop the search early, once the result isn't needed anymore.
+ * @param highest		If true this method looks for the highest valid number, otherwise the lowest.
+ * @return	The first valid number found, or -1 if none was found or the search was stopped.
+ */
+int64_t find_first_runner_compiled(const solverfunc solve_prefix,
+		const std::array<uint8_t, 3> digits, std::atomic<bool> *stop,
+		const bool highest);
+
+/**
+ * Claims and checks prefixes in search order, using the given prefix solver, until none are left.
+ * Every worker claims the next unclaimed prefix, so the workers always check the earliest remaining prefixes.
+ * Once a valid number is found, all later prefixes are stopped.
+ *
+ * @tparam S				The type of the prefix solver.
+ * @param search			The shared state of the search.
+ * @param solve_prefix		A function searching for the first valid number with a given prefix.
+ * 							Takes the prefix digits and a stop flag, and returns the number, or -1.
+ * @param highest			If true the search order starts with the highest prefix, otherwise the lowest.
+ */
+template<typename S>
+void search_prefixes(PrefixSearch &search, const S &solve_prefix,
 		const bool highest);
 
+/**
+ * Multithreaded method searching for the first valid 14 digit number.
+ * Checks all three digit prefixes using one search_prefixes task per worker of a thread pool
+ * with one thread per hardware thread.
+ * The first valid number in search order is returned as soon as all earlier prefixes are checked.
+ *
+ * @tparam S				The type of the prefix solver.
+ * @param solve_prefix		A function searching for the first valid number with a given prefix.
+ * 							Takes the prefix digits and a stop flag, and returns the number, or -1.
+ * @param highest			If true this method looks for the highest valid number, otherwise the lowest.
+ * @param prefix			The only prefix to check, on the calling thread. All prefixes if not set.
+ * @return	The first valid number, or -1 if none was found.
+ */
+template<typename S>
+int64_t find_first_prefix(const S &solve_prefix, const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix = std::nullopt);
+
 /**
  * Multithreaded method searching for the first valid 14 digit number.
  * Runs the instructions in the run_program interpreter.
  *
  * @param insts		The instructions to execute to validate a possible input number.
  * @param highest	If true this method looks for the highest valid number, otherwise the lowest.
+ * @param prefix	The only prefix to check. All prefixes if not set.
  * @return	The highest valid number, or -1 if none was found.
  */
 int64_t find_first_valid_interpreted(const std::vector<Instruction> insts,
-		const bool highest);
+		const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix = std::nullopt);
 
 /**
  * Multithreaded method searching for the first valid 14 digit number.
- * Runs the external program created by compile_instructions.
+ * Runs machine code generated from the instructions using jit_compile.
  *
+ * @param insts		The instructions to execute to validate a possible input number.
  * @param highest	If true this method looks for the highest valid number, otherwise the lowest.
- * @param exe		The executable to be run to check a number segment.
+ * @param prefix	The only prefix to check. All prefixes if not set.
  * @return	The highest valid number, or -1 if none was found.
  */
-int64_t find_first_valid_compiled(const std::filesystem::path exe,
-		const bool highest);
+int64_t find_first_valid_jit(const std::vector<Instruction> insts,
+		const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix = std::nullopt);
 
 /**
- * Generates a single SIMD intrinsics call.
+ * Multithreaded method searching for the first valid 14 digit number.
+ * Runs the instructions in the pre-decoded bytecode interpreter run_bytecode.
  *
- * This function will not generate any padding.
+ * @param insts		The instructions to execute to validate a possible input number.
+ * @param highest	If true this method looks for the highest valid number, otherwise the lowest.
+ * @param prefix	The only prefix to check. All prefixes if not set.
+ * @return	The highest valid number, or -1 if none was found.
+ */
+int64_t find_first_valid_bytecode(const std::vector<Instruction> insts,
+		const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix = std::nullopt);
+
+/**
+ * Multithreaded method searching for the first valid 14 digit number.
+ * Runs the given segment function using find_first_runner, or find_first_runner_memoized.
+ * Which one is used depends on SEARCH_MODE, and on how many registers are live between the segments.
  *
- * @param out		The output stream to write the generated call to.
- * @param fn_name	The name of the SIMD intrinsics function.
- * @param regset	The register set to use for the call.
- * 					NOTE: unlike other uses in this program,
- * 					regset may be multiple characters long.
- * @param reg_a		The output and primary input register index to use.
- * @param in_b		The secondary input to use. May be a register or a constant.
- * @param const_b	Whether the secondary input is a constant.
+ * @tparam F			The type of the segment function.
+ * @param run_segment	A function executing a single segment of the input.
+ * 						Takes the segment index, the initial registers, the output registers, and the input digit.
+ * @param live_regs		The live registers at the start of each segment, as found by find_live_registers.
+ * @param highest		If true this method looks for the highest valid number, otherwise the lowest.
+ * @param prefix		The only prefix to check. All prefixes if not set.
+ * @return	The highest valid number, or -1 if none was found.
  */
-void generate_simd_call(std::ostream &out, const char *fn_name,
-		const char *regset, const uint16_t reg_a, const uint32_t in_b,
-		const bool const_b);
+template<typename F>
+int64_t find_first_valid(const F &run_segment, const uint8_t live_regs[14],
+		const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix = std::nullopt);
 
 /**
- * Generates the C code for a single instruction.
+ * Multithreaded method searching for the first valid 14 digit number.
+ * Calls a solve_prefix function of the shared library created by compile_instructions.
  *
- * This function will generate the SIMD code for all 9 possible values if simd is true,
- * but only the code for a single value if simd is false.
+ * @param solve_prefix	The solver function to use, as selected by select_solver.
+ * @param highest		If true this method looks for the highest valid number, otherwise the lowest.
+ * @param prefix		The only prefix to check. All prefixes if not set.
+ * @return	The highest valid number, or -1 if none was found.
+ */
+int64_t find_first_valid_compiled(const solverfunc solve_prefix,
+		const bool highest,
+		const std::optional<std::array<uint8_t, 3>> prefix = std::nullopt);
+
+/**
+ * Selects the solver function of the given library to use, based on SIMD_MODE and SIMD_TARGET.
+ * In SIMD_AUTO mode this uses the widest target supported by the CPU, as detected by detect_simd_targets.
+ *
+ * @param solver	The loaded solver library.
+ * @return	The selected solver function, or NULL if the library doesn't export it.
+ */
+solverfunc select_solver(const CompiledSolver &solver);
+
+/**
+ * Times the solver function for each SIMD target supported by the CPU, and the scalar one,
+ * on the prefix of the given number, and prints the results as a table.
+ * Since each function stops at the given number, they all do the same amount of work.
+ *
+ * @param solver	The loaded solver library.
+ * @param number	A valid number, found by the same search.
+ * @param highest	If true the solvers search for the highest valid number, otherwise the lowest.
+ */
+void benchmark_simd_targets(const CompiledSolver &solver, const int64_t number,
+		const bool highest);
+
+/**
+ * Generates the C code for a single instruction.
  *
  * @param inst		The instruction to generate code for.
  * @param out		The output stream to write the generated code to.
  * @param inp_idx	The number of input instructions before the current instruction.
  * 					If the current instruction is an input instruction it should also be counted.
- * @param simd		Whether to generate SIMD code instead of standard code.
  */
 void generate_instruction_code(const Instruction &inst, std::ostream &out,
-		const uint16_t inp_idx, const bool simd);
+		const uint16_t inp_idx);
+
+/**
+ * Generates the SIMD code executing a single instruction for all 9 possible values of the current digit.
+ * Every register of the register set is an array of vectors, together holding one lane per digit.
+ *
+ * @param inst		The instruction to generate code for.
+ * @param out		The output stream to write the generated code to.
+ * @param simd		The SIMD target to generate the code for.
+ * @param regset	The register set to use.
+ * @param vectors	The number of vectors per register.
+ * @param indent	The indentation to write before each line.
+ */
+void generate_simd_instruction(const Instruction &inst, std::ostream &out,
+		const SIMDInfo &simd, const char regset, const uint8_t vectors,
+		const std::string &indent);
+
+/**
+ * Generates the code calculating the number found by a solver from the prefix and the loop variables.
+ * Declares a long long int variable called result containing it.
+ *
+ * @param out		The output stream to write the generated code to.
+ * @param indent	The indentation to write before each line.
+ */
+void generate_solver_result(std::ostream &out, const std::string &indent);
+
+/**
+ * Generates a solve_prefix function for the given SIMD target.
+ * Every segment after the first three is run once for all 9 possible digits,
+ * before looping over the resulting register states.
+ *
+ * @param insts		The instructions to generate the solver for.
+ * @param out		The output stream to write the generated function to.
+ * @param simd		The SIMD target to generate the function for.
+ * @param inps		The indices of the input instructions, as found by find_segments.
+ * @param live_regs	The live registers at the start of each segment, as found by find_live_registers.
+ */
+void generate_simd_solver(const std::vector<Instruction> &insts,
+		std::ostream &out, const SIMDInfo &simd, const size_t inps[15],
+		const uint8_t live_regs[14]);
 
 /**
  * Compiles the given set of instructions to a native library in the given temporary directory.
  * The instructions are split into functions such that each function only gets one input digit.
+ * When solving, the library exports a solve_prefix function, to be loaded using CompiledSolver.
+ * If simd is true it also exports a solve_prefix function for each SIMD target up to SIMD_TARGET,
+ * for example solve_prefix_avx2.
+ * Otherwise an executable taking the input digits as arguments is created.
+ * If CACHE_COMPILATIONS is set, a previous build of the same code with the same command
+ * is copied from the cache instead of compiling it again.
  *
  * @param insts		The instructions to compile to a native library.
  * @param tempDir	The directory in which to generate the code and compile the library.
  * @param comp		The compiler to use to compile the instructions.
+ * @param simd		Whether to also generate the SIMD solver functions.
  * @return	Whether the compilation was successful.
  */
 bool compile_instructions(const std::vector<Instruction> insts,
-		const std::filesystem::path tmpDir, const Compiler comp);
+		const std::filesystem::path tmpDir, const Compiler comp,
+		const bool simd);
 
 /**
  * Finds the compiler to use.
@@ -373,15 +1273,47 @@ bool compile_instructions(const std::vector<Instruction> insts,
 Compiler detect_compiler();
 
 /**
- * Attempts to automatically detect cpu, os, and compiler support for SIMD instructions.
+ * Detects the SIMD targets supported by the cpu and os using cpuid.
+ * Always returns 0 on non x86 platforms.
  *
- * Since the current SIMD support of this program requires SSE4.1, that is what this function checks for.
+ * @return	A bit mask with the bit 1 << target set for each supported SIMDTarget.
+ */
+uint8_t detect_simd_targets();
+
+/**
+ * Calculates the 64 bit FNV-1a hash of the given data.
+ * Unlike std::hash this is the same for every build and platform, so it can be used as a persistent key.
+ *
+ * @param data	The data to hash.
+ * @return	The hash of the data.
+ */
+uint64_t fnv1a_hash(const std::string_view data);
+
+/**
+ * Gets the version information printed by the given compiler.
+ * Used as part of the compilation cache key, so that builds of an older compiler version aren't reused.
+ *
+ * @param comp	The compiler to get the version of.
+ * @return	The output of the version command, or an empty string if it couldn't be run.
+ */
+std::string get_compiler_version(const Compiler comp);
+
+/**
+ * Gets the path of the cached library or executable with the given key.
+ * The file extension matches that of get_temp_output.
+ *
+ * @param key	The hash of the compiler command, compiler version, and source code the file was built from.
+ * @return	The path of the file in CACHE_DIR.
+ */
+std::filesystem::path get_cache_path(const uint64_t key);
+
+/**
+ * Gets the path of the library or executable created by compile_instructions.
  *
- * @param comp		The compiler to use.
- * @param tmpDir	The temporary directory to generate the test executable in.
- * @return	True if SSE4.1 is supported, false if it isn't supported and null if the test could not be run.
+ * @param tmpDir	The temporary directory the library is created in.
+ * @return	The path of the library when solving, or that of the executable otherwise.
  */
-std::optional<bool> detect_simd(const Compiler comp, const std::filesystem::path tmpDir);
+std::filesystem::path get_temp_output(const std::filesystem::path tmpDir);
 
 /**
  * Creates a temporary shared library from the given instructions in a temporary directory.
@@ -397,7 +1329,7 @@ std::optional<std::filesystem::path> create_temp_lib(
 
 /**
  * Deletes the temporary shared library and directory.
- * Deletes tmp.c, tmp.o, tmp.Makefile, and the given temp lib before trying to delete the directory.
+ * Deletes the given temp lib, and the other files created while building it, before trying to delete the directory.
  *
  * @param tmpDir	The temporary directory to delete the temp files in.
  * @param tmpLib	The temporary shared library to delete.
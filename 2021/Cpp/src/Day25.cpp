@@ -10,7 +10,7 @@
 #include <vector>
 
 template<>
-void DayRunner<25>::solve(std::ifstream input) {
+void DayRunner<25>::solve(aoc::input_stream input) {
 	std::vector<std::string> lines;
 
 	std::string line;
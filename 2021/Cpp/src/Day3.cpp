@@ -9,7 +9,7 @@
 #include <iostream>
 
 template<>
-void DayRunner<3>::solve(std::ifstream input) {
+void DayRunner<3>::solve(aoc::input_stream input) {
 	std::string line;
 	std::vector<uint16_t> lines;
 	while (input >> line) {
@@ -11,7 +11,7 @@
 #include <sstream>
 
 template<>
-void DayRunner<4>::solve(std::ifstream input) {
+void DayRunner<4>::solve(aoc::input_stream input) {
 	std::string token;
 	input >> token;
 	std::replace(token.begin(), token.end(), ',', ' ');
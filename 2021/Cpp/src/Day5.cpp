@@ -6,38 +6,35 @@
  */
 
 #include "Main.h"
+#include "Lines.h"
+#include "Parse.h"
 #include <algorithm>
 #include <iostream>
 #include <map>
-#include <sstream>
 
 template<>
-void DayRunner<5>::solve(std::ifstream input) {
-	std::string line;
+void DayRunner<5>::solve(aoc::input_stream input) {
 	uint16_t x1 = 0, y1 = 0, x2 = 0, y2 = 0;
-	std::istringstream converter;
+	std::pair<uint16_t, uint16_t> start, end;
 	std::map<std::pair<uint16_t, uint16_t>, uint8_t> lines;
 
-	while (input >> line) {
-		if (line.find(',') != std::string::npos) {
-			std::replace(line.begin(), line.end(), ',', ' ');
-			converter.clear();
-			converter.str(line);
+	for (std::string_view line : aoc::line_range(input.view(), true)) {
+		if (!aoc::parse::pair(line, start) || !aoc::parse::skip(line, " -> ")
+				|| !aoc::parse::pair(line, end)) {
+			std::cerr << "Failed to parse line \"" << line << "\"." << std::endl;
+			continue;
+		}
 
-			if (x1 == 0 && y1 == 0) {
-				converter >> x1 >> y1;
-			} else {
-				converter >> x2 >> y2;
-				if (x1 == x2 || y1 == y2) {
-					for (uint16_t x = std::min(x1, x2); x <= std::max(x1, x2);
-							x++) {
-						for (uint16_t y = std::min(y1, y2);
-								y <= std::max(y1, y2); y++) {
-							lines[ { x, y }]++;
-						}
-					}
+		x1 = start.first;
+		y1 = start.second;
+		x2 = end.first;
+		y2 = end.second;
+		if (x1 == x2 || y1 == y2) {
+			for (uint16_t x = std::min(x1, x2); x <= std::max(x1, x2); x++) {
+				for (uint16_t y = std::min(y1, y2); y <= std::max(y1, y2);
+						y++) {
+					lines[ { x, y }]++;
 				}
-				x1 = y1 = x2 = y2 = 0;
 			}
 		}
 	}
@@ -51,31 +48,28 @@ void DayRunner<5>::solve(std::ifstream input) {
 
 	std::cout << "Found " << dangers << " part 1 dangerous spots." << std::endl;
 
-	input = getInputFileStream(5);
-	while (input >> line) {
-		if (line.find(',') != std::string::npos) {
-			std::replace(line.begin(), line.end(), ',', ' ');
-			converter.clear();
-			converter.str(line);
+	for (std::string_view line : aoc::line_range(input.view(), true)) {
+		if (!aoc::parse::pair(line, start) || !aoc::parse::skip(line, " -> ")
+				|| !aoc::parse::pair(line, end)) {
+			std::cerr << "Failed to parse line \"" << line << "\"." << std::endl;
+			continue;
+		}
 
-			if (x1 == 0 && y1 == 0) {
-				converter >> x1 >> y1;
+		x1 = start.first;
+		y1 = start.second;
+		x2 = end.first;
+		y2 = end.second;
+		if (x1 != x2 && y1 != y2) {
+			if (x1 < x2) {
+				for (uint16_t x = x1, y = y1; x <= x2;
+						x++, y1 > y2 ? y-- : y++) {
+					lines[ { x, y }]++;
+				}
 			} else {
-				converter >> x2 >> y2;
-				if (x1 != x2 && y1 != y2) {
-					if (x1 < x2) {
-						for (uint16_t x = x1, y = y1; x <= x2;
-								x++, y1 > y2 ? y-- : y++) {
-							lines[ { x, y }]++;
-						}
-					} else {
-						for (uint16_t x = x1, y = y1; x >= x2;
-								x--, y1 > y2 ? y-- : y++) {
-							lines[ { x, y }]++;
-						}
-					}
+				for (uint16_t x = x1, y = y1; x >= x2;
+						x--, y1 > y2 ? y-- : y++) {
+					lines[ { x, y }]++;
 				}
-				x1 = y1 = x2 = y2 = 0;
 			}
 		}
 	}
@@ -11,7 +11,7 @@
 #include <sstream>
 
 template<>
-void DayRunner<6>::solve(std::ifstream input) {
+void DayRunner<6>::solve(aoc::input_stream input) {
 	std::string line;
 	input >> line;
 	std::replace(line.begin(), line.end(), ',', ' ');
@@ -13,7 +13,7 @@
 #include <vector>
 
 template<>
-void DayRunner<7>::solve(std::ifstream input) {
+void DayRunner<7>::solve(aoc::input_stream input) {
 	std::string input_str;
 	input >> input_str;
 	std::replace(input_str.begin(), input_str.end(), ',', ' ');
@@ -15,7 +15,7 @@
 #include <vector>
 
 template<>
-void DayRunner<8>::solve(std::ifstream input) {
+void DayRunner<8>::solve(aoc::input_stream input) {
 
 	std::unordered_set<char> number_to_chars[10];
 	number_to_chars[0] = { 'a', 'b', 'c', 'e', 'f', 'g' };
@@ -12,7 +12,7 @@
 #include <vector>
 
 template<>
-void DayRunner<9>::solve(std::ifstream input) {
+void DayRunner<9>::solve(aoc::input_stream input) {
 	uint8_t map[100][100];
 
 	std::string line;
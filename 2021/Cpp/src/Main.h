@@ -8,7 +8,8 @@
 #ifndef MAIN_H_
 #define MAIN_H_
 
-#include <fstream>
+#include "Input.h"
+#include "Runner.h"
 #include <string>
 #include <utility>
 
@@ -21,69 +22,35 @@
  */
 int main(int argc, char *argv[]);
 
-/*
- * Gets a file input stream for the input file for the given day.
- * Ends the program if the file can't be found.
- *
- * @param day	The day for which to get the input stream.
- * @return	A ifstream for the input file for the given day.
- */
-std::ifstream getInputFileStream(const uint8_t day);
-
-/**
- * Prints the help text for this program to the system output.
- *
- * @param filename	The current execution path of this process.
- */
-void printUsage(const char *filename);
-
-class AoCRunner {
-public:
-	virtual ~AoCRunner() {
-	}
-
-	/*
-	 * Solves the task for the given day.
-	 * Runs both part 1 and 2 and prints the result to the system output stream.
-	 */
-	virtual void solve() = 0;
-};
-
 template<uint8_t Day>
-class DayRunner: public AoCRunner {
+class DayRunner {
 public:
-	virtual ~DayRunner() {
-	}
-
 	/*
 	 * Returns the day this implementation is the solution for.
 	 */
-	uint8_t getDay() {
+	static constexpr uint8_t getDay() {
 		return Day;
 	}
 
-	void solve() override {
-		solve(getInputFileStream(Day));
-	}
-
 	/*
 	 * Solves the task for the given day.
 	 * Runs both part 1 and 2 and prints the result to the system output stream.
 	 *
-	 * @param input	An ifstream to the input file for the current day.
+	 * @param input	An input stream reading the input file for the current day.
 	 */
-	void solve(std::ifstream input);
+	static void solve(aoc::input_stream input);
 };
 
 /*
- * Gets a pointer to the DayRunner for the given day.
+ * Creates the table of the solvers for the given days.
  *
- * @tparam Days	An integer_sequence containing all the currently implemented days.
- * @param day	The day for which to get the runner.
- * @return	A pointer to the DayRunner for the given day.
+ * @tparam Days	An integer_sequence containing all the currently implemented days, minus one.
+ * @return	A table containing the DayRunner solve function for each of the given days.
  */
 template<uint8_t ... Days>
-AoCRunner* getRunner(const uint8_t day,
-		const std::integer_sequence<uint8_t, Days...>);
+constexpr aoc::day_table createDayTable(
+		const std::integer_sequence<uint8_t, Days...>) {
+	return { {aoc::day_solver(), aoc::day_solver(&DayRunner<Days + 1>::solve)...}};
+}
 
 #endif /* MAIN_H_ */
@@ -7,7 +7,7 @@
 
 #include "Main.h"
 
-std::string day10part1(std::ifstream input) {
+std::string day10part1(aoc::input_stream input) {
 	int64_t registerX = 1;
 	uint64_t score = 0;
 	uint16_t clock = 0;
@@ -34,7 +34,7 @@ std::string day10part1(std::ifstream input) {
 	return std::to_string(score);
 }
 
-std::string day10part2(std::ifstream input) {
+std::string day10part2(aoc::input_stream input) {
 	int64_t registerX = 1;
 	std::string image = "\n";
 	uint16_t clock = 0;
@@ -62,6 +62,3 @@ std::string day10part2(std::ifstream input) {
 	}
 	return image;
 }
-
-bool d10p1 = aoc::registerPart1(10, &day10part1);
-bool d10p2 = aoc::registerPart2(10, &day10part2);
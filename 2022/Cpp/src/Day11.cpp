@@ -6,6 +6,7 @@
  */
 
 #include "Day11.h"
+#include "Parse.h"
 #include <algorithm>
 #include <cctype>
 
@@ -83,7 +84,7 @@ void aoc::Monkey::turn() {
 	items.clear();
 }
 
-std::vector<aoc::Monkey> aoc::parse_monkeys(std::vector<std::string> lines) {
+std::vector<aoc::Monkey> aoc::parse_monkeys(const std::string_view input) {
 	std::vector<aoc::Monkey> monkeys;
 	std::vector<std::pair<uint8_t, uint8_t>> targets;
 	uint8_t id = 0;
@@ -94,7 +95,10 @@ std::vector<aoc::Monkey> aoc::parse_monkeys(std::vector<std::string> lines) {
 	uint8_t test_divisor = 0;
 	//Which of the 5 lines of a monkey definition are we parsing
 	uint8_t ln = 0;
-	for (std::string line : lines) {
+	for (std::string_view line : aoc::line_range(input, true)) {
+		line.remove_prefix(
+				std::find_if_not(line.begin(), line.end(),
+						(int (*)(int)) (std::isspace)) - line.begin());
 		if (line.length() == 0) {
 			continue;
 		}
@@ -107,7 +111,8 @@ std::vector<aoc::Monkey> aoc::parse_monkeys(std::vector<std::string> lines) {
 						<< "\"." << std::endl;
 				err = true;
 			} else {
-				id = std::stoi(line.substr(7, line.length() - 8));
+				id = aoc::parse::to_number<uint8_t>(
+						line.substr(7, line.length() - 8));
 			}
 			break;
 		case 1:
@@ -119,11 +124,13 @@ std::vector<aoc::Monkey> aoc::parse_monkeys(std::vector<std::string> lines) {
 				items = std::vector<uint64_t>();
 				line = line.substr(16);
 				size_t comma;
-				while ((comma = line.find(',')) != std::string::npos) {
-					items.push_back(std::stoi(line.substr(0, comma)));
+				while ((comma = line.find(',')) != std::string_view::npos) {
+					items.push_back(
+							aoc::parse::to_number<uint64_t>(
+									line.substr(0, comma)));
 					line = line.substr(comma + 2);
 				}
-				items.push_back(std::stoi(line));
+				items.push_back(aoc::parse::to_number<uint64_t>(line));
 			}
 			break;
 		case 2:
@@ -137,7 +144,7 @@ std::vector<aoc::Monkey> aoc::parse_monkeys(std::vector<std::string> lines) {
 				if (line == "old") {
 					operation_second = -1;
 				} else {
-					operation_second = std::stoi(line);
+					operation_second = aoc::parse::to_number<int8_t>(line);
 				}
 			}
 			break;
@@ -147,7 +154,7 @@ std::vector<aoc::Monkey> aoc::parse_monkeys(std::vector<std::string> lines) {
 						<< "\"." << std::endl;
 				err = true;
 			} else {
-				test_divisor = std::stoi(line.substr(19));
+				test_divisor = aoc::parse::to_number<uint8_t>(line.substr(19));
 			}
 			break;
 		case 4:
@@ -156,7 +163,8 @@ std::vector<aoc::Monkey> aoc::parse_monkeys(std::vector<std::string> lines) {
 						<< "\"." << std::endl;
 				err = true;
 			} else {
-				targets.push_back( { std::stoi(line.substr(25)), 0 });
+				targets.push_back(
+						{ aoc::parse::to_number<uint8_t>(line.substr(25)), 0 });
 			}
 			break;
 		case 5:
@@ -165,7 +173,8 @@ std::vector<aoc::Monkey> aoc::parse_monkeys(std::vector<std::string> lines) {
 						<< "\"." << std::endl;
 				err = true;
 			} else {
-				targets.back().second = std::stoi(line.substr(26));
+				targets.back().second = aoc::parse::to_number<uint8_t>(
+						line.substr(26));
 			}
 			break;
 		}
@@ -203,18 +212,8 @@ std::ostream& aoc::operator<<(std::ostream &stream, const aoc::Monkey &monkey) {
 	return stream;
 }
 
-std::string day11part1(std::ifstream input) {
-	std::vector<std::string> lines;
-	std::string line;
-	while (std::getline(input, line)) {
-		if (line.length() > 0) {
-			line.erase(line.begin(),
-					std::find_if_not(line.begin(), line.end(),
-							(int (*)(int)) (std::isspace)));
-			lines.push_back(line);
-		}
-	}
-	std::vector<aoc::Monkey> monkeys = aoc::parse_monkeys(lines);
+std::string day11part1(aoc::input_stream input) {
+	std::vector<aoc::Monkey> monkeys = aoc::parse_monkeys(input.view());
 
 	for (uint8_t i = 0; i < 20; i++) {
 		for (aoc::Monkey &monkey : monkeys) {
@@ -231,18 +230,8 @@ std::string day11part1(std::ifstream input) {
 	return std::to_string(inspections[0] * inspections[1]);
 }
 
-std::string day11part2(std::ifstream input) {
-	std::vector<std::string> lines;
-	std::string line;
-	while (std::getline(input, line)) {
-		if (line.length() > 0) {
-			line.erase(line.begin(),
-					std::find_if_not(line.begin(), line.end(),
-							(int (*)(int)) (std::isspace)));
-			lines.push_back(line);
-		}
-	}
-	std::vector<aoc::Monkey> monkeys = aoc::parse_monkeys(lines);
+std::string day11part2(aoc::input_stream input) {
+	std::vector<aoc::Monkey> monkeys = aoc::parse_monkeys(input.view());
 
 	uint64_t lcm = monkeys[0].get_test_divisor();
 	uint64_t gcd, a, b;
@@ -275,6 +264,3 @@ std::string day11part2(std::ifstream input) {
 
 	return std::to_string(inspections[0] * inspections[1]);
 }
-
-bool d11p1 = aoc::registerPart1(11, &day11part1);
-bool d11p2 = aoc::registerPart2(11, &day11part2);
@@ -148,12 +148,12 @@ public:
 };
 
 /**
- * Parses the given vector of lines to a vector of the monkeys represented by those lines.
+ * Parses the given input text to a vector of the monkeys represented by it.
  *
- * @param lines	The lines to parse.
+ * @param input	The input text to parse.
  * @return	The newly parsed monkeys.
  */
-std::vector<aoc::Monkey> parse_monkeys(const std::vector<std::string> lines);
+std::vector<aoc::Monkey> parse_monkeys(const std::string_view input);
 
 /**
  * Print this monkeys id and how many items it has already inspected to the given output stream.
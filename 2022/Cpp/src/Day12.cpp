@@ -32,7 +32,7 @@ bool aoc::check_position(const std::vector<std::vector<uint8_t>> &heights,
 	return true;
 }
 
-std::string day12part1(std::ifstream input) {
+std::string day12part1(aoc::input_stream input) {
 	std::vector<std::vector<uint8_t>> heights;
 	std::string line;
 	std::pair<uint8_t, uint8_t> start_pos;
@@ -207,7 +207,7 @@ std::string day12part1(std::ifstream input) {
 	return std::to_string(costs[start_pos]);
 }
 
-std::string day12part2(std::ifstream input) {
+std::string day12part2(aoc::input_stream input) {
 	std::vector<std::vector<uint8_t>> heights;
 	std::string line;
 	std::pair<uint8_t, uint8_t> end_pos;
@@ -317,6 +317,3 @@ std::string day12part2(std::ifstream input) {
 
 	return std::to_string(min_cost);
 }
-
-bool d12p1 = aoc::registerPart1(12, &day12part1);
-bool d12p2 = aoc::registerPart2(12, &day12part2);
@@ -129,7 +129,7 @@ bool aoc::compare_lists(const std::string &first, const std::string &second) {
 	return false;
 }
 
-std::string day13part1(std::ifstream input) {
+std::string day13part1(aoc::input_stream input) {
 	std::string last_line;
 	std::string line;
 	uint32_t pair_idx = 0;
@@ -157,7 +157,7 @@ std::string day13part1(std::ifstream input) {
 	return std::to_string(idx_sum);
 }
 
-std::string day13part2(std::ifstream input) {
+std::string day13part2(aoc::input_stream input) {
 	std::vector<std::string> lines;
 	std::string line;
 	while (std::getline(input, line)) {
@@ -186,6 +186,3 @@ std::string day13part2(std::ifstream input) {
 
 	return std::to_string(first * second);
 }
-
-bool d13p1 = aoc::registerPart1(13, &day13part1);
-bool d13p2 = aoc::registerPart2(13, &day13part2);
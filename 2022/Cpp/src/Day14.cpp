@@ -6,27 +6,23 @@
  */
 
 #include "Main.h"
+#include "Parse.h"
 
-std::string day14part1(std::ifstream input) {
+std::string day14part1(aoc::input_stream input) {
 	std::vector<std::array<uint16_t, 4>> lines;
-	std::string line;
 	uint16_t x_offset = UINT16_MAX;
 	uint16_t x_max = 0;
 	uint16_t y_max = 0;
-	while (std::getline(input, line)) {
-		if (line.length() == 0) {
+	for (std::string_view line : aoc::line_range(input.view(), true)) {
+		std::pair<uint16_t, uint16_t> pos;
+		if (!aoc::parse::pair(line, pos)) {
+			std::cerr << "Failed to parse line \"" << line << "\"." << std::endl;
 			continue;
 		}
 
-		size_t comma_idx = line.find(',');
-		size_t space_idx = line.find(' ');
 		std::array<uint16_t, 4> arr;
-		arr[2] = std::stoi(line.substr(0, comma_idx));
-		arr[3] = std::stoi(
-				line.substr(comma_idx + 1, space_idx - comma_idx - 1));
-		line = line.substr(line.find(' ', space_idx + 1) + 1);
-		comma_idx = line.find(',');
-		space_idx = line.find(' ');
+		arr[2] = pos.first;
+		arr[3] = pos.second;
 
 		if (arr[2] < x_offset) {
 			x_offset = arr[2];
@@ -38,22 +34,9 @@ std::string day14part1(std::ifstream input) {
 			y_max = arr[3];
 		}
 
-		while (comma_idx != std::string::npos) {
-			arr = { arr[2], arr[3], 0, 0 };
-			arr[2] = std::stoi(line.substr(0, comma_idx));
-			arr[3] = std::stoi(
-					line.substr(comma_idx + 1,
-							space_idx == std::string::npos ?
-									space_idx : space_idx - comma_idx - 1));
-			if (space_idx != std::string::npos) {
-				line = line.substr(line.find(' ', space_idx + 1) + 1);
-			} else {
-				line = "";
-			}
-
+		while (aoc::parse::skip(line, " -> ") && aoc::parse::pair(line, pos)) {
+			arr = { arr[2], arr[3], pos.first, pos.second };
 			lines.push_back(arr);
-			comma_idx = line.find(',');
-			space_idx = line.find(' ');
 
 			if (arr[2] < x_offset) {
 				x_offset = arr[2];
@@ -109,26 +92,21 @@ std::string day14part1(std::ifstream input) {
 	return std::to_string(count - 1);
 }
 
-std::string day14part2(std::ifstream input) {
+std::string day14part2(aoc::input_stream input) {
 	std::vector<std::array<uint16_t, 4>> lines;
-	std::string line;
 	uint16_t x_offset = UINT16_MAX;
 	uint16_t x_max = 0;
 	uint16_t y_max = 0;
-	while (std::getline(input, line)) {
-		if (line.length() == 0) {
+	for (std::string_view line : aoc::line_range(input.view(), true)) {
+		std::pair<uint16_t, uint16_t> pos;
+		if (!aoc::parse::pair(line, pos)) {
+			std::cerr << "Failed to parse line \"" << line << "\"." << std::endl;
 			continue;
 		}
 
-		size_t comma_idx = line.find(',');
-		size_t space_idx = line.find(' ');
 		std::array<uint16_t, 4> arr;
-		arr[2] = std::stoi(line.substr(0, comma_idx));
-		arr[3] = std::stoi(
-				line.substr(comma_idx + 1, space_idx - comma_idx - 1));
-		line = line.substr(line.find(' ', space_idx + 1) + 1);
-		comma_idx = line.find(',');
-		space_idx = line.find(' ');
+		arr[2] = pos.first;
+		arr[3] = pos.second;
 
 		if (arr[2] < x_offset) {
 			x_offset = arr[2];
@@ -140,22 +118,9 @@ std::string day14part2(std::ifstream input) {
 			y_max = arr[3];
 		}
 
-		while (comma_idx != std::string::npos) {
-			arr = { arr[2], arr[3], 0, 0 };
-			arr[2] = std::stoi(line.substr(0, comma_idx));
-			arr[3] = std::stoi(
-					line.substr(comma_idx + 1,
-							space_idx == std::string::npos ?
-									space_idx : space_idx - comma_idx - 1));
-			if (space_idx != std::string::npos) {
-				line = line.substr(line.find(' ', space_idx + 1) + 1);
-			} else {
-				line = "";
-			}
-
+		while (aoc::parse::skip(line, " -> ") && aoc::parse::pair(line, pos)) {
+			arr = { arr[2], arr[3], pos.first, pos.second };
 			lines.push_back(arr);
-			comma_idx = line.find(',');
-			space_idx = line.find(' ');
 
 			if (arr[2] < x_offset) {
 				x_offset = arr[2];
@@ -209,6 +174,3 @@ std::string day14part2(std::ifstream input) {
 
 	return std::to_string(count);
 }
-
-bool d14p1 = aoc::registerPart1(14, &day14part1);
-bool d14p2 = aoc::registerPart2(14, &day14part2);
@@ -6,6 +6,7 @@
  */
 
 #include "Day15.h"
+#include "Parse.h"
 
 aoc::sensor::sensor(const std::pair<int64_t, int64_t> sensor_pos,
 		const std::pair<int64_t, int64_t> beacon_pos) :
@@ -66,34 +67,20 @@ std::ostream& aoc::operator<<(std::ostream &stream, const sensor &sensor) {
 	return stream;
 }
 
-std::string day15part1(std::ifstream input) {
+std::string day15part1(aoc::input_stream input) {
 	std::vector<aoc::sensor> sensors;
 	const int64_t checked_line = 2000000;
-	std::string line;
-	while (std::getline(input, line)) {
-		if (line.length() == 0) {
-			continue;
-		}
-
-		size_t start_pos = 12;
-		size_t end_pos = line.find(',', start_pos);
+	for (std::string_view line : aoc::line_range(input.view(), true)) {
 		std::pair<int64_t, int64_t> sensor_pos;
-		sensor_pos.first = std::stoi(
-				line.substr(start_pos, end_pos - start_pos));
-		start_pos = end_pos + 4;
-		end_pos = line.find(':', start_pos);
-		sensor_pos.second = std::stoi(
-				line.substr(start_pos, end_pos - start_pos));
-
-		start_pos = end_pos + 25;
-		end_pos = line.find(',', start_pos);
 		std::pair<int64_t, int64_t> beacon_pos;
-		beacon_pos.first = std::stoi(
-				line.substr(start_pos, end_pos - start_pos));
-		start_pos = end_pos + 4;
-		end_pos = line.length();
-		beacon_pos.second = std::stoi(
-				line.substr(start_pos, end_pos - start_pos));
+		if (!aoc::parse::next_number(line, sensor_pos.first)
+				|| !aoc::parse::next_number(line, sensor_pos.second)
+				|| !aoc::parse::next_number(line, beacon_pos.first)
+				|| !aoc::parse::next_number(line, beacon_pos.second)) {
+			std::cerr << "Failed to parse sensor line \"" << line << "\"."
+					<< std::endl;
+			continue;
+		}
 		sensors.push_back(aoc::sensor(sensor_pos, beacon_pos));
 	}
 
@@ -105,34 +92,20 @@ std::string day15part1(std::ifstream input) {
 	return std::to_string(checked_positions.size());
 }
 
-std::string day15part2(std::ifstream input) {
+std::string day15part2(aoc::input_stream input) {
 	std::vector<aoc::sensor> sensors;
 	const int64_t max_pos = 4000000;
-	std::string line;
-	while (std::getline(input, line)) {
-		if (line.length() == 0) {
-			continue;
-		}
-
-		size_t start_pos = 12;
-		size_t end_pos = line.find(',', start_pos);
+	for (std::string_view line : aoc::line_range(input.view(), true)) {
 		std::pair<int64_t, int64_t> sensor_pos;
-		sensor_pos.first = std::stoi(
-				line.substr(start_pos, end_pos - start_pos));
-		start_pos = end_pos + 4;
-		end_pos = line.find(':', start_pos);
-		sensor_pos.second = std::stoi(
-				line.substr(start_pos, end_pos - start_pos));
-
-		start_pos = end_pos + 25;
-		end_pos = line.find(',', start_pos);
 		std::pair<int64_t, int64_t> beacon_pos;
-		beacon_pos.first = std::stoi(
-				line.substr(start_pos, end_pos - start_pos));
-		start_pos = end_pos + 4;
-		end_pos = line.length();
-		beacon_pos.second = std::stoi(
-				line.substr(start_pos, end_pos - start_pos));
+		if (!aoc::parse::next_number(line, sensor_pos.first)
+				|| !aoc::parse::next_number(line, sensor_pos.second)
+				|| !aoc::parse::next_number(line, beacon_pos.first)
+				|| !aoc::parse::next_number(line, beacon_pos.second)) {
+			std::cerr << "Failed to parse sensor line \"" << line << "\"."
+					<< std::endl;
+			continue;
+		}
 		sensors.push_back(aoc::sensor(sensor_pos, beacon_pos));
 	}
 
@@ -165,6 +138,3 @@ std::string day15part2(std::ifstream input) {
 
 	return std::to_string(x * 4000000 + y);
 }
-
-bool d15p1 = aoc::registerPart1(15, &day15part1);
-bool d15p2 = aoc::registerPart2(15, &day15part2);
@@ -6,8 +6,15 @@
  */
 
 #include "Day16.h"
+#include "Options.h"
+#include "Parse.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <map>
-#include <unordered_set>
+#include <memory>
 
 aoc::valve::valve() noexcept :
 		index(0), name(NULL), name_len(0), flow_rate(0), state(false), opened(
@@ -176,580 +183,602 @@ void aoc::swap(valve &first, valve &second) noexcept {
 	swap(first.num_connections, second.num_connections);
 }
 
-aoc::state::state(const uint64_t flow_rate, const uint64_t time,
-		const uint64_t released, const valve *valves, const size_t num_valves,
-		const size_t *positions, const size_t *targets, const size_t num_agents) :
-		flow_rate(flow_rate), time(time), released(released), valves(
-				num_valves > 0 ? new valve[num_valves] : NULL), num_valves(
-				num_valves), positions(
-				num_agents > 0 ? new size_t[num_agents] : NULL), targets(
-				num_agents > 0 ? new size_t[num_agents] : NULL), num_agents(
-				num_agents), distances(
-				num_agents > 0 ? new size_t[num_agents] : NULL), traveled(
-				num_agents > 0 ? new size_t[num_agents] { 0 } : NULL) {
-	if (num_valves > 0) {
-		std::copy(valves, valves + num_valves, this->valves);
-	}
-
-	if (num_agents > 0) {
-		std::copy(positions, positions + num_agents, this->positions);
-		if (targets != NULL) {
-			std::copy(targets, targets + num_agents, this->targets);
-		} else {
-			std::copy(positions, positions + num_agents, this->targets);
+aoc::distance_matrix::distance_matrix(const std::vector<valve> &valves,
+		const std::vector<size_t> &nodes) :
+		size(nodes.size()), row_lines(
+				(nodes.size() + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE), lines(
+				size * row_lines) {
+	std::vector<size_t> distances(valves.size());
+	std::vector<size_t> queue;
+	for (size_t from = 0; from < size; from++) {
+		std::fill(distances.begin(), distances.end(), SIZE_MAX);
+		distances[nodes[from]] = 0;
+		queue.clear();
+		queue.push_back(nodes[from]);
+		for (size_t i = 0; i < queue.size(); i++) {
+			const valve &current = valves[queue[i]];
+			for (const size_t *connected = current.get_connections_ptr();
+					connected
+							< current.get_connections_ptr()
+									+ current.get_connections_count();
+					connected++) {
+				if (distances[*connected] == SIZE_MAX) {
+					distances[*connected] = distances[queue[i]] + 1;
+					queue.push_back(*connected);
+				}
+			}
 		}
 
-		for (size_t i = 0; i < num_agents; i++) {
-			distances[i] = get_distance(positions[i], targets[i]);
+		uint8_t *row = lines[from * row_lines].distances;
+		for (size_t to = 0; to < size; to++) {
+			// Unreachable valves are further away than any time limit.
+			row[to] = std::min<size_t>(distances[nodes[to]], UINT8_MAX);
 		}
 	}
 }
 
-aoc::state::state(const state &state) :
-		flow_rate(state.flow_rate), time(state.time), released(state.released), valves(
-				state.num_valves > 0 ? new valve[state.num_valves] : NULL), num_valves(
-				state.num_valves), positions(
-				state.num_agents > 0 ? new size_t[state.num_agents] : NULL), targets(
-				state.num_agents > 0 ? new size_t[state.num_agents] : NULL), num_agents(
-				state.num_agents), distances(
-				state.num_agents > 0 ? new size_t[state.num_agents] : NULL), traveled(
-				state.num_agents > 0 ? new size_t[state.num_agents] : NULL) {
-	if (num_valves > 0) {
-		std::copy(state.valves, state.valves + state.num_valves, valves);
-	}
-
-	if (num_agents > 0) {
-		std::copy(state.positions, state.positions + state.num_agents,
-				positions);
-		std::copy(state.targets, state.targets + state.num_agents, targets);
-		std::copy(state.distances, state.distances + state.num_agents,
-				distances);
-		std::copy(state.traveled, state.traveled + state.num_agents, traveled);
-	}
+size_t aoc::distance_matrix::get_size() const {
+	return size;
 }
 
-aoc::state::state(state &&state) noexcept :
-		flow_rate(0), time(0), released(0), valves(NULL), num_valves(0), positions(
-		NULL), targets(NULL), num_agents(0), distances(NULL), traveled(NULL) {
-	using std::swap;
-
-	swap(*this, state);
-}
-
-aoc::state::~state() {
-	delete[] valves;
-	delete[] positions;
-	delete[] targets;
-	delete[] distances;
-	delete[] traveled;
+const uint8_t* aoc::distance_matrix::get_row(const size_t from) const {
+	return lines[from * row_lines].distances;
 }
 
-aoc::state& aoc::state::operator=(state state) noexcept {
-	using std::swap;
-
-	swap(*this, state);
-	return *this;
-}
-
-bool aoc::state::operator==(const state &other) const {
-	if (flow_rate != other.flow_rate || time != other.time
-			|| released != other.released || num_valves != other.num_valves
-			|| num_agents != other.num_agents) {
-		return false;
-	}
-
-	for (size_t i = 0; i < num_valves; i++) {
-		if (valves[i] != other.valves[i]) {
-			return false;
-		}
+uint8_t aoc::distance_matrix::get_distance(const size_t from,
+		const size_t to) const {
+	if (from >= size) {
+		throw std::out_of_range("Start index out of range.");
 	}
-
-	for (size_t i = 0; i < num_agents; i++) {
-		if (positions[i] != other.positions[i] || targets[i] != other.targets[i]
-				|| distances[i] != other.distances[i]
-				|| traveled[i] != other.traveled[i]) {
-			return false;
-		}
+	if (to >= size) {
+		throw std::out_of_range("End index out of range.");
 	}
 
-	return true;
-}
-
-bool aoc::state::operator!=(const state &other) const {
-	return !this->operator ==(other);
-}
-
-aoc::state aoc::state::update() const {
-	return add_time(1);
+	return get_row(from)[to];
 }
 
-aoc::state aoc::state::add_time(const uint64_t time) const {
-	state new_state(*this);
-	if (time == 0) {
-		return new_state;
+aoc::valve_network aoc::build_network(const std::vector<valve> &valves,
+		const size_t start_pos) {
+	std::vector<size_t> flow_valves;
+	for (const valve &valve : valves) {
+		if (valve.get_flow_rate() > 0) {
+			flow_valves.push_back(valve.get_index());
+		}
 	}
 
-	new_state.time += time;
-	new_state.released += new_state.flow_rate * time;
-	for (size_t agent = 0; agent < new_state.num_agents; agent++) {
-		const size_t remaining_travel = new_state.distances[agent]
-				- new_state.traveled[agent];
-		if (time < remaining_travel) {
-			new_state.traveled[agent] += time;
-		} else {
-			const size_t target = new_state.targets[agent];
-			if (!new_state.valve_open(target) && remaining_travel < time) {
-				const uint64_t open_time = new_state.time + remaining_travel
-						- time + 1;
-				new_state.valves[target] = new_state.valves[target].open(
-						open_time);
-				const uint8_t new_valve_flow_rate =
-						new_state.valves[target].get_flow_rate();
-				new_state.flow_rate += new_valve_flow_rate;
-				new_state.released += new_valve_flow_rate
-						* (new_state.time - open_time);
-			}
-			new_state.positions[agent] = target;
-			new_state.distances[agent] = new_state.traveled[agent] = 0;
-		}
+	// Order the valves by flow rate, so the upper bound of the search doesn't have to sort them.
+	std::stable_sort(flow_valves.begin(), flow_valves.end(),
+			[&valves](const size_t first, const size_t second) {
+				return valves[first].get_flow_rate()
+						> valves[second].get_flow_rate();
+			});
+
+	if (flow_valves.size() > MAX_FLOW_VALVES) {
+		throw std::invalid_argument("Too many valves with a flow rate.");
 	}
-	return new_state;
-}
 
-aoc::state aoc::state::run_to_nex_target(const uint64_t max_time) const {
-	if (max_time == 0) {
-		return state(*this);
+	valve_network network;
+	network.size = flow_valves.size();
+	for (const size_t valve : flow_valves) {
+		network.flow_rates.push_back(valves[valve].get_flow_rate());
 	}
 
-	uint64_t time = max_time;
-	for (size_t agent = 0; agent < num_agents; agent++) {
-		if (positions[agent] == targets[agent]
-				&& valves[positions[agent]].is_open()) {
-			return state(*this);
-		}
+	// The start position is the last row and column of the matrix.
+	flow_valves.push_back(start_pos);
+	network.distances = std::make_shared<const distance_matrix>(valves,
+			flow_valves);
 
-		if (distances[agent] - traveled[agent] < time - 1) {
-			time = distances[agent] - traveled[agent] + 1;
-		}
-	}
-	return add_time(time);
+	return network;
 }
 
-uint64_t aoc::state::get_flow_rate() const {
-	return flow_rate;
-}
+/**
+ * The number of entries a state can be stored in.
+ * The entries of the table are split into aligned buckets of this size.
+ */
+const size_t VISITED_BUCKET_SIZE = 8;
 
-aoc::state aoc::state::set_flow_rate(const uint64_t flow_rate) const {
-	state new_state(*this);
-	new_state.flow_rate = flow_rate;
-	return new_state;
-}
+/**
+ * The number of locks protecting the buckets of a visited table.
+ */
+const size_t VISITED_STRIPES = 256;
 
-aoc::state aoc::state::add_flow_rate(const uint64_t flow_rate) const {
-	state new_state(*this);
-	new_state.flow_rate += flow_rate;
-	return new_state;
-}
+/**
+ * The number of moves after which the parallel search splits the search tree into tasks.
+ */
+const size_t SPLIT_DEPTH = 2;
 
-uint64_t aoc::state::get_time() const {
-	return time;
-}
+/**
+ * The max amount of memory the visited table may use, in MiB.
+ * 0 to not use a visited table.
+ * Only searches with multiple agents use a visited table,
+ * since a single agent visits too few states for it to pay off.
+ */
+size_t VISITED_TABLE_MIB = 64;
 
-uint64_t aoc::state::get_released() const {
-	return released;
-}
+/**
+ * Whether to print the statistics of the visited table after each search.
+ */
+bool REPORT_VISITED = false;
 
-size_t aoc::state::get_position(const size_t agent) const {
-	if (agent >= num_agents) {
-		throw std::out_of_range("Agent index out of range.");
-	}
-	return positions[agent];
-}
+/**
+ * Whether to assign the agents disjoint subsets of the valves for searches with multiple agents,
+ * rather than searching the moves of all agents at once.
+ */
+bool SUBSET_AGENTS = true;
 
-aoc::state aoc::state::set_position(const size_t agent,
-		const size_t position) const {
-	if (agent >= num_agents) {
-		throw std::out_of_range("Agent index out of range.");
-	}
-	if (position >= num_valves) {
-		throw std::out_of_range("Position out of range.");
-	}
+/**
+ * The number of threads to search on, if the day isn't running on a thread pool already.
+ * 0 to use one thread per hardware thread, and 1 to search on the calling thread.
+ */
+size_t SEARCH_THREADS = 0;
 
-	state new_state(*this);
-	new_state.positions[agent] = position;
-	new_state.distances[agent] = get_distance(new_state.positions[agent],
-			position);
-	new_state.traveled[agent] = 0;
-	return new_state;
-}
+aoc::visited_table::visited_table(const size_t max_capacity,
+		const size_t memory) :
+		stripes(new stripe[VISITED_STRIPES]) {
+	size_t capacity = VISITED_BUCKET_SIZE;
+	while (capacity * 2 <= max_capacity
+			&& capacity * 2 * sizeof(entry)
+					+ capacity * 2 / VISITED_BUCKET_SIZE <= memory) {
+		capacity *= 2;
+	}
+	entries.resize(capacity);
+	hands.resize(capacity / VISITED_BUCKET_SIZE);
 
-size_t aoc::state::get_target(const size_t agent) const {
-	if (agent >= num_agents) {
-		throw std::out_of_range("Agent index out of range.");
+	for (size_t i = 0; i < VISITED_STRIPES; i++) {
+		stripes[i].hits = stripes[i].misses = stripes[i].evictions = 0;
 	}
-	return targets[agent];
 }
 
-aoc::state aoc::state::set_target(const size_t agent,
-		const size_t position) const {
-	if (agent >= num_agents) {
-		throw std::out_of_range("Agent index out of range.");
+bool aoc::visited_table::check(const search_state &state,
+		const size_t num_agents) {
+	// The agents are interchangeable, so sort them to find states with swapped agents.
+	std::array<uint16_t, MAX_AGENTS> agents { 0 };
+	for (size_t i = 0; i < num_agents; i++) {
+		agents[i] = state.positions[i] << 8 | state.times[i];
 	}
-	if (position >= num_valves) {
-		throw std::out_of_range("Position out of range.");
+	std::sort(agents.begin(), agents.begin() + num_agents);
+	uint64_t packed = 0;
+	for (size_t i = 0; i < num_agents; i++) {
+		packed = packed << 16 | agents[i];
+	}
+
+	uint64_t hash = (state.open ^ (packed * 0x9E3779B97F4A7C15ull))
+			* 0xBF58476D1CE4E5B9ull;
+	hash ^= hash >> 31;
+	const size_t bucket = hash & (entries.size() / VISITED_BUCKET_SIZE - 1);
+	entry *const entries = &this->entries[bucket * VISITED_BUCKET_SIZE];
+	stripe &stripe = stripes[bucket % VISITED_STRIPES];
+	std::lock_guard<std::mutex> lock(stripe.mutex);
+	for (size_t i = 0; i < VISITED_BUCKET_SIZE; i++) {
+		entry &current = entries[i];
+		if (!current.used) {
+			stripe.misses++;
+			current = { state.open, packed, state.released, true, true };
+			return false;
+		}
+
+		if (current.open == state.open && current.agents == packed) {
+			stripe.hits++;
+			current.referenced = true;
+			if (current.released >= state.released) {
+				return true;
+			}
+			current.released = state.released;
+			return false;
+		}
 	}
 
-	state new_state(*this);
-	new_state.targets[agent] = position;
-	new_state.distances[agent] = get_distance(new_state.positions[agent],
-			position);
-	return new_state;
+	// Evict the first entry that wasn't used since the last time the hand of this bucket passed it.
+	stripe.misses++;
+	stripe.evictions++;
+	uint8_t &hand = hands[bucket];
+	while (entries[hand].referenced) {
+		entries[hand].referenced = false;
+		hand = (hand + 1) % VISITED_BUCKET_SIZE;
+	}
+	entries[hand] = { state.open, packed, state.released, true, true };
+	hand = (hand + 1) % VISITED_BUCKET_SIZE;
+	return false;
 }
 
-size_t aoc::state::get_agents_count() const {
-	return num_agents;
+size_t aoc::visited_table::get_capacity() const {
+	return entries.size();
 }
 
-size_t aoc::state::get_size() const {
-	return get_valves_count();
+uint64_t aoc::visited_table::get_hits() const {
+	uint64_t hits = 0;
+	for (size_t i = 0; i < VISITED_STRIPES; i++) {
+		std::lock_guard<std::mutex> lock(stripes[i].mutex);
+		hits += stripes[i].hits;
+	}
+	return hits;
 }
 
-const std::vector<aoc::valve> aoc::state::get_valves() const {
-	return std::vector<aoc::valve>(valves, valves + num_valves);
+uint64_t aoc::visited_table::get_misses() const {
+	uint64_t misses = 0;
+	for (size_t i = 0; i < VISITED_STRIPES; i++) {
+		std::lock_guard<std::mutex> lock(stripes[i].mutex);
+		misses += stripes[i].misses;
+	}
+	return misses;
 }
 
-size_t aoc::state::get_valves_count() const {
-	return num_valves;
+uint64_t aoc::visited_table::get_evictions() const {
+	uint64_t evictions = 0;
+	for (size_t i = 0; i < VISITED_STRIPES; i++) {
+		std::lock_guard<std::mutex> lock(stripes[i].mutex);
+		evictions += stripes[i].evictions;
+	}
+	return evictions;
 }
 
-const aoc::valve& aoc::state::get_valve(const size_t index) const {
-	if (index >= num_valves) {
-		throw std::out_of_range("Valve index out of range.");
+/**
+ * The arguments of a search shared by all of its states.
+ */
+struct max_released_search {
+	/**
+	 * The valve network to search.
+	 */
+	const aoc::valve_network &network;
+
+	/**
+	 * The time at which the search ends.
+	 */
+	const size_t time;
+
+	/**
+	 * The number of agents opening valves.
+	 */
+	const size_t num_agents;
+
+	/**
+	 * The table of the states that were already visited. May be NULL.
+	 */
+	aoc::visited_table *visited;
+
+	/**
+	 * The max amount of pressure found to be released so far.
+	 * Shared by all threads, so a better result found by one lets all of them prune more states.
+	 */
+	std::atomic<uint64_t> max_released;
+
+	/**
+	 * If not NULL, the states reached after SPLIT_DEPTH moves are added to this vector,
+	 * instead of being searched.
+	 */
+	std::vector<aoc::search_state> *frontier;
+};
+
+/**
+ * The states a parallel search splits its search tree into, and the state of their search.
+ * Shared between the calling thread and the pool tasks helping it,
+ * so tasks that only start once all states were claimed can still safely check for more.
+ */
+struct frontier_search {
+	/**
+	 * The search the states belong to.
+	 */
+	max_released_search search;
+
+	/**
+	 * The states reached after SPLIT_DEPTH moves, which are searched independently.
+	 */
+	std::vector<aoc::search_state> frontier;
+
+	/**
+	 * The index of the next state of the frontier to be claimed by a thread.
+	 */
+	std::atomic<size_t> next;
+
+	/**
+	 * The number of states of the frontier that weren't fully searched yet.
+	 */
+	size_t remaining;
+
+	/**
+	 * The mutex protecting remaining.
+	 */
+	std::mutex mutex;
+
+	/**
+	 * The condition variable notified once all states of the frontier were searched.
+	 */
+	std::condition_variable finished;
+
+	/**
+	 * Creates a new frontier search with an empty frontier.
+	 *
+	 * @param network		The valve network to search.
+	 * @param time			The time at which the search ends.
+	 * @param num_agents	The number of agents opening valves.
+	 * @param visited		The table of the states that were already visited. May be NULL.
+	 */
+	frontier_search(const aoc::valve_network &network, const size_t time,
+			const size_t num_agents, aoc::visited_table *visited) :
+			search { network, time, num_agents, visited, { 0 }, NULL }, next(
+					0), remaining(0) {
+	}
+};
+
+/**
+ * Calculates an upper bound for the pressure that can be released from the given state.
+ * Assumes that the closed valves are opened in the order of their flow rates,
+ * with each agent opening one every two time units.
+ * The valves of the network are ordered by flow rate, so this is a single pass over the closed valves.
+ * Only called for states that the bound using the closed flow of the state can't discard.
+ *
+ * @param network		The valve network the state belongs to.
+ * @param state			The state to calculate the upper bound for.
+ * @param now			The earliest time at which an agent can move again.
+ * @param time			The time at which the search ends.
+ * @param num_agents	The number of agents opening valves.
+ * @return	The max amount of pressure that could be released from the given state.
+ */
+uint64_t get_upper_bound(const aoc::valve_network &network,
+		const aoc::search_state &state, const size_t now, const size_t time,
+		const size_t num_agents) {
+	uint64_t bound = state.released;
+	uint64_t closed_valves = ~state.open;
+	for (size_t closed = 0; closed_valves != 0; closed++) {
+		const size_t valve = __builtin_ctzll(closed_valves);
+		const size_t opened = now + closed / num_agents * 2 + 1;
+		if (valve >= network.size || opened >= time) {
+			break;
+		}
+		bound += network.flow_rates[valve] * (time - opened);
+		closed_valves &= closed_valves - 1;
 	}
-	return valves[index];
+	return bound;
 }
 
-aoc::state aoc::state::set_valve(valve &valve) const {
-	if (valve.get_index() > num_valves) {
-		throw std::out_of_range("Valve index out of range.");
+/**
+ * Recursively searches for the max amount of pressure that can be released,
+ * starting from the given state.
+ * Always moves the agent that finishes opening its valve first.
+ *
+ * @param search	The search this state belongs to.
+ * @param state		The state to continue searching from.
+ * @param depth		The number of moves made to reach this state.
+ */
+void search_max_released(max_released_search &search,
+		const aoc::search_state &state, const size_t depth) {
+	uint64_t max_released = search.max_released.load(
+			std::memory_order_relaxed);
+	while (state.released > max_released
+			&& !search.max_released.compare_exchange_weak(max_released,
+					state.released, std::memory_order_relaxed)) {
+	}
+
+	size_t agent = 0;
+	for (size_t i = 1; i < search.num_agents; i++) {
+		if (state.times[i] < state.times[agent]) {
+			agent = i;
+		}
 	}
 
-	state new_state(*this);
-	if (valve.get_index() == num_valves) {
-		new_state.valves = new aoc::valve[num_valves + 1];
-		new_state.num_valves = num_valves + 1;
-	} else {
-		new_state.valves = new aoc::valve[num_valves];
-		new_state.num_valves = num_valves;
+	// Check the cheap bound assuming all closed valves open right away first.
+	const size_t now = state.times[agent];
+	const uint64_t best = search.max_released.load(std::memory_order_relaxed);
+	if (now >= search.time
+			|| state.released + state.closed_flow * (search.time - now - 1)
+					<= best
+			|| get_upper_bound(search.network, state, now, search.time,
+					search.num_agents) <= best) {
+		return;
 	}
 
-	std::copy(valves, valves + num_valves, new_state.valves);
-	new_state.valves[valve.get_index()] = valve;
-	return new_state;
-}
-
-aoc::state aoc::state::add_valve(const std::string name,
-		const uint8_t flow_rate, const bool open, const uint64_t opened,
-		std::vector<size_t> &connections) const {
-	state new_state(*this);
-	new_state.valves = new valve[num_valves + 1];
-	new_state.num_valves = num_valves + 1;
-	std::copy(valves, valves + num_valves, new_state.valves);
-	new_state.valves[num_valves] = valve(new_state.num_valves, name, flow_rate,
-			open, opened, connections.data(), connections.size());
-	return new_state;
-}
-
-bool aoc::state::valve_open(const size_t index) const {
-	if (index >= num_valves) {
-		throw std::out_of_range("Valve index out of range.");
+	if (search.frontier != NULL && depth == SPLIT_DEPTH) {
+		search.frontier->push_back(state);
+		return;
 	}
 
-	return valves[index].is_open();
-}
-
-aoc::state aoc::state::open_valve(const size_t index) const {
-	if (index >= num_valves) {
-		throw std::out_of_range("Valve index out of range.");
+	// Splitting the search tree only visits a few states, so don't store those.
+	if (search.frontier == NULL && search.visited != NULL
+			&& search.visited->check(state, search.num_agents)) {
+		return;
 	}
 
-	state new_state(*this);
-	if (!new_state.valves[index].is_open()) {
-		new_state.valves[index] = new_state.valves[index].open(time);
-		new_state.flow_rate += new_state.valves[index].get_flow_rate();
-	}
-	return new_state;
-}
+	const uint8_t *distances = search.network.distances->get_row(
+			state.positions[agent]);
+	for (size_t valve = 0; valve < search.network.size; valve++) {
+		const size_t opened = now + distances[valve] + 1;
+		if ((state.open & (1ull << valve)) != 0 || opened >= search.time) {
+			continue;
+		}
 
-uint8_t aoc::state::get_valve_flow_rate(const size_t index) const {
-	if (index >= num_valves) {
-		throw std::out_of_range("Valve index out of range.");
+		aoc::search_state next = state;
+		next.open |= 1ull << valve;
+		next.released += search.network.flow_rates[valve]
+				* (search.time - opened);
+		next.closed_flow -= search.network.flow_rates[valve];
+		next.positions[agent] = valve;
+		next.times[agent] = opened;
+		search_max_released(search, next, depth + 1);
 	}
 
-	return valves[index].get_flow_rate();
+	// Let this agent stop, so the others can open the remaining valves.
+	if (search.num_agents > 1) {
+		aoc::search_state next = state;
+		next.times[agent] = search.time;
+		search_max_released(search, next, depth + 1);
+	}
 }
 
-const std::vector<size_t> aoc::state::get_valve_connections(
-		const size_t index) const {
-	if (index >= num_valves) {
-		throw std::out_of_range("Valve index out of range.");
+/**
+ * Claims and searches states of the given frontier until none are left.
+ * Used by both the thread starting a parallel search and the pool tasks helping it,
+ * so the starting thread never has to run unrelated tasks while waiting.
+ *
+ * @param work	The frontier to search.
+ */
+void search_frontier(frontier_search &work) {
+	size_t index;
+	while ((index = work.next++) < work.frontier.size()) {
+		search_max_released(work.search, work.frontier[index], SPLIT_DEPTH);
+
+		// Decrementing while holding the lock prevents lost wakeups.
+		std::lock_guard<std::mutex> lock(work.mutex);
+		if (--work.remaining == 0) {
+			work.finished.notify_all();
+		}
 	}
-
-	return valves[index].get_connections();
 }
 
-size_t aoc::state::get_distance(const size_t from, const size_t to) const {
-	if (from >= num_valves) {
-		throw std::out_of_range("Start index out of range.");
+uint64_t aoc::get_max_released(const valve_network &network,
+		const size_t time, const size_t num_agents, visited_table *visited,
+		thread_pool *pool) {
+	if (num_agents == 0 || num_agents > MAX_AGENTS) {
+		throw std::invalid_argument("Unsupported number of agents.");
 	}
-	if (to >= num_valves) {
-		throw std::out_of_range("End index out of range.");
+	if (time > UINT8_MAX) {
+		throw std::invalid_argument("Time limit out of range.");
 	}
 
-	if (from == to) {
-		return 0;
+	search_state start { 0, 0, 0, { 0 }, { 0 } };
+	for (size_t i = 0; i < num_agents; i++) {
+		start.positions[i] = network.size;
+	}
+	for (const uint8_t flow_rate : network.flow_rates) {
+		start.closed_flow += flow_rate;
 	}
 
-	std::map<size_t, size_t> known_distances;
-	known_distances[from] = 0;
-	std::vector<size_t> stack;
-	stack.push_back(from);
-	while (stack.size() > 0) {
-		const size_t pos = stack.back();
-		stack.pop_back();
-		const size_t distance = known_distances[pos];
-		if (known_distances.count(to) == 1 && distance >= known_distances[to]) {
-			continue;
-		}
-
-		for (const size_t *connected = valves[pos].get_connections_ptr();
-				connected
-						< valves[pos].get_connections_ptr()
-								+ valves[pos].get_connections_count();
-				connected++) {
-			if (known_distances.count(*connected) == 0
-					|| distance + 1 < known_distances[*connected]) {
-				known_distances[*connected] = distance + 1;
-				stack.push_back(*connected);
-			}
-		}
+	if (pool == NULL) {
+		max_released_search search { network, time, num_agents, visited, {
+				0 }, NULL };
+		search_max_released(search, start, 0);
+		return search.max_released;
 	}
 
-	return known_distances[to];
-}
+	// Collect the states after the first few moves, to be claimed one by one by this thread and the tasks.
+	const std::shared_ptr<frontier_search> work = std::make_shared<
+			frontier_search>(network, time, num_agents, visited);
+	work->search.frontier = &work->frontier;
+	search_max_released(work->search, start, 0);
+	work->search.frontier = NULL;
+	work->remaining = work->frontier.size();
 
-size_t aoc::state::get_distance_to_target(const size_t agent) const {
-	if (agent >= num_agents) {
-		throw std::out_of_range("Agent index out of range.");
+	const size_t tasks = std::min(pool->get_thread_count(),
+			work->frontier.size());
+	for (size_t i = 0; i < tasks; i++) {
+		pool->submit([work]() {
+			search_frontier(*work);
+		});
 	}
 
-	return distances[agent];
+	search_frontier(*work);
+	std::unique_lock<std::mutex> lock(work->mutex);
+	work->finished.wait(lock, [&work]() {
+		return work->remaining == 0;
+	});
+	return work->search.max_released;
 }
 
-void aoc::state::print_to(std::ostream &stream, const bool multiline) const {
-	if (multiline) {
-		stream << "########## STATE ##########" << std::endl;
-		stream << "Time: " << time << std::endl;
-		stream << "Flow Rate: " << flow_rate << std::endl;
-		stream << "Released: " << released << std::endl;
-		stream << "AGENTS(" << num_agents << "):" << std::endl;
-		for (size_t i = 0; i < num_agents; i++) {
-			stream << "\tagent[index=";
-			stream << i;
-			stream << ", position=";
-			stream << valves[positions[i]].get_name() << '(' << positions[i]
-					<< ')';
-			stream << ", target=";
-			stream << valves[targets[i]].get_name() << '(' << targets[i] << ')';
-			stream << ", distance=";
-			stream << distances[i];
-			stream << ", traveled=";
-			stream << traveled[i];
-			stream << ']' << std::endl;
-		}
-		stream << "VALVES(" << num_valves << "):" << std::endl;
-		for (size_t i = 0; i < num_valves; i++) {
-			stream << "\tvalve[index=" << valves[i].get_index();
-			stream << ", name=" << valves[i].get_name();
-			stream << ", flow rate=" << (uint16_t) valves[i].get_flow_rate();
-			stream << ", state=" << (valves[i].is_open() ? "open" : "closed");
-			stream << ", opening time=" << valves[i].get_opened();
-			stream << ", connections=[";
-			for (size_t j = 0; j < valves[i].get_connections_count(); j++) {
-				stream << valves[valves[i].get_connections()[j]].get_name()
-						<< '(' << valves[i].get_connections()[j] << ')';
-				if (j < valves[i].get_connections_count() - 1) {
-					stream << ", ";
-				}
-			}
-			stream << "]]" << std::endl;
-		}
-	} else {
-		stream << "state[total flow rate=" << flow_rate;
-		stream << ", time=" << time;
-		stream << ", released=" << released;
-		stream << ", agents=[";
-		for (size_t i = 0; i < num_agents; i++) {
-			stream << "agent[index=";
-			stream << i;
-			stream << ", position=";
-			stream << positions[i];
-			stream << ", target=";
-			stream << targets[i];
-			stream << ", distance=";
-			stream << distances[i];
-			stream << ", traveled=";
-			stream << traveled[i];
-			if (i < num_agents - 1) {
-				stream << "], ";
-			} else {
-				stream << ']';
-			}
-		}
-		stream << "], valves=[";
-		for (size_t i = 0; i < num_valves; i++) {
-			stream << valves[i];
-			if (i < num_valves - 1) {
-				stream << ", ";
-			}
+/**
+ * Recursively records the max amount of pressure a single agent can release
+ * for each set of opened valves reachable from the given state.
+ *
+ * @param network	The valve network to search.
+ * @param state		The state to continue searching from.
+ * @param time		The time at which the search ends.
+ * @param released	The max released pressure for each open mask, to update.
+ */
+void search_subsets(const aoc::valve_network &network,
+		const aoc::search_state &state, const size_t time,
+		std::vector<uint32_t> &released) {
+	if (state.released > released[state.open]) {
+		released[state.open] = state.released;
+	}
+
+	const size_t now = state.times[0];
+	const uint8_t *distances = network.distances->get_row(
+			state.positions[0]);
+	for (size_t valve = 0; valve < network.size; valve++) {
+		const size_t opened = now + distances[valve] + 1;
+		if ((state.open & (1ull << valve)) != 0 || opened >= time) {
+			continue;
 		}
-		stream << "]]";
-	}
-}
 
-std::ostream& aoc::operator<<(std::ostream &stream, const aoc::state &state) {
-	state.print_to(stream);
-	return stream;
+		aoc::search_state next = state;
+		next.open |= 1ull << valve;
+		next.released += network.flow_rates[valve] * (time - opened);
+		next.closed_flow -= network.flow_rates[valve];
+		next.positions[0] = valve;
+		next.times[0] = opened;
+		search_subsets(network, next, time, released);
+	}
 }
 
-void aoc::swap(state &first, state &second) noexcept {
-	using std::swap;
-
-	swap(first.flow_rate, second.flow_rate);
-	swap(first.time, second.time);
-	swap(first.released, second.released);
-	swap(first.valves, second.valves);
-	swap(first.num_valves, second.num_valves);
-	swap(first.positions, second.positions);
-	swap(first.targets, second.targets);
-	swap(first.num_agents, second.num_agents);
-	swap(first.distances, second.distances);
-	swap(first.traveled, second.traveled);
-}
-
-uint64_t aoc::get_max_released(std::vector<valve> valves, size_t start_pos,
-		size_t time, size_t num_agents) {
-	using std::hash;
-
-	size_t *initial_positions = new size_t[num_agents];
-	for (size_t i = 0; i < num_agents; i++) {
-		initial_positions[i] = start_pos;
-	}
-
-	std::vector<state> stack;
-	stack.push_back(
-			state(0, 0, 0, valves.data(), valves.size(), initial_positions,
-					initial_positions, num_agents));
-	// Only store hashes to avoid needing over 10GB of RAM.
-	std::unordered_set<size_t> checked;
-	size_t max_released = 0;
-	while (stack.size() > 0) {
-		const state current_state = stack.back();
-		stack.pop_back();
-		checked.insert(hash<state>()(current_state));
-		std::vector<size_t> closed_valves;
-		std::vector<uint64_t> closed_flow_rates;
-		for (size_t i = 0; i < current_state.get_size(); i++) {
-			if (!current_state.valve_open(i)
-					&& current_state.get_valve_flow_rate(i) > 0) {
-				closed_valves.push_back(i);
-				closed_flow_rates.push_back(
-						current_state.get_valve_flow_rate(i));
-			}
-		}
+std::vector<uint32_t> aoc::get_max_released_per_subset(
+		const valve_network &network, const size_t time) {
+	if (network.size > MAX_SUBSET_VALVES) {
+		throw std::invalid_argument("Too many valves for a subset search.");
+	}
+	if (time > UINT8_MAX) {
+		throw std::invalid_argument("Time limit out of range.");
+	}
 
-		if (closed_valves.size() == 0) {
-			state new_state(current_state);
-			if (time - current_state.get_time() > 0) {
-				new_state = new_state.add_time(time - current_state.get_time());
-			}
+	std::vector<uint32_t> released(1ull << network.size, 0);
+	search_state start { 0, 0, 0, { 0 }, { 0 } };
+	start.positions[0] = network.size;
+	search_subsets(network, start, time, released);
 
-			if (max_released < new_state.get_released()) {
-				max_released = new_state.get_released();
+	// Make each subset the max of its subsets, so the combination doesn't have to enumerate them.
+	for (size_t valve = 0; valve < network.size; valve++) {
+		for (size_t mask = 0; mask < released.size(); mask++) {
+			if ((mask & (1ull << valve)) != 0) {
+				released[mask] = std::max(released[mask],
+						released[mask ^ (1ull << valve)]);
 			}
-			continue;
-		}
-
-		// Ignore states that cannot be better than the current best.
-		std::sort(closed_flow_rates.rbegin(), closed_flow_rates.rend());
-		size_t mrel = current_state.get_released()
-				+ current_state.get_flow_rate()
-						* (time - current_state.get_time());
-		for (size_t i = 0;
-				i * 2 + 1 < time - current_state.get_time()
-						&& i < closed_flow_rates.size(); i++) {
-			mrel += closed_flow_rates[i]
-					* (time - current_state.get_time() - i * 2 - 1);
-		}
-		if (mrel < max_released) {
-			continue;
 		}
+	}
 
-		std::vector<state> new_states;
-		new_states.push_back(current_state);
-		for (size_t agent = 0; agent < current_state.get_agents_count();
-				agent++) {
-			const size_t current_pos = current_state.get_position(agent);
-			if (current_pos != current_state.get_target(agent)
-					|| (!current_state.valve_open(current_pos)
-							&& current_state.get_valve_flow_rate(current_pos)
-									> 0)) {
-				continue;
-			}
+	return released;
+}
 
-			for (state st : std::vector<state>(new_states)) {
-				new_states.erase(
-						std::find(new_states.begin(), new_states.end(), st));
-				for (const size_t val : closed_valves) {
-					bool found = false;
-					for (size_t i = 0; i < st.get_agents_count(); i++) {
-						if (st.get_target(i) == val) {
-							found = true;
-							break;
-						}
-					}
-					if (!found) {
-						new_states.push_back(st.set_target(agent, val));
-					}
-				}
-			}
+uint64_t aoc::get_max_released_subsets(const valve_network &network,
+		const size_t time, const size_t num_agents) {
+	if (num_agents == 0) {
+		throw std::invalid_argument("Unsupported number of agents.");
+	}
+
+	const std::vector<uint32_t> single = get_max_released_per_subset(network,
+			time);
+	const size_t full = single.size() - 1;
+
+	// The max pressure the first N agents can release using only the valves of each subset.
+	std::vector<uint32_t> combined = single;
+	for (size_t agent = 2; agent < num_agents; agent++) {
+		std::vector<uint32_t> next(combined.size(), 0);
+		for (size_t mask = 0; mask <= full; mask++) {
+			// Enumerate all subsets of mask, including mask itself and the empty set.
+			size_t subset = mask;
+			do {
+				next[mask] = std::max<uint32_t>(next[mask],
+						combined[subset] + single[mask ^ subset]);
+				subset = (subset - 1) & mask;
+			} while (subset != mask);
 		}
+		combined = std::move(next);
+	}
 
-		for (state new_state : new_states) {
-			if (new_state.get_time() < time) {
-				new_state = new_state.run_to_nex_target(
-						time - new_state.get_time());
-				if (new_state.get_time() == time
-						&& new_state.get_released() > max_released) {
-					max_released = new_state.get_released();
-				}
-			}
-
-			if (new_state.get_time() == time) {
-				if (max_released < new_state.get_released()) {
-					max_released = new_state.get_released();
-				}
-			} else if (new_state.get_time() < time
-					&& std::count(stack.begin(), stack.end(), new_state) == 0
-					&& checked.count(hash<state>()(new_state)) == 0) {
-				stack.push_back(std::move(new_state));
-			}
-		}
+	if (num_agents == 1) {
+		return combined[full];
 	}
 
+	uint64_t max_released = 0;
+	for (size_t mask = 0; mask <= full; mask++) {
+		max_released = std::max<uint64_t>(max_released,
+				combined[mask] + single[full ^ mask]);
+	}
 	return max_released;
 }
 
+uint64_t aoc::get_max_released(const std::vector<valve> &valves,
+		const size_t start_pos, const size_t time, const size_t num_agents) {
+	return get_max_released(build_network(valves, start_pos), time,
+			num_agents);
+}
+
 size_t std::hash<aoc::valve>::operator()(const aoc::valve &valve) const noexcept {
 	size_t result = 1;
 	result = result * 31 + hash<size_t>()(valve.index);
@@ -764,62 +793,151 @@ size_t std::hash<aoc::valve>::operator()(const aoc::valve &valve) const noexcept
 	return result;
 }
 
-size_t std::hash<aoc::state>::operator()(const aoc::state &state) const noexcept {
-	size_t result = 1;
-	result = result * 31 + hash<uint64_t>()(state.flow_rate);
-	result = result * 31 + hash<uint64_t>()(state.time);
-	result = result * 31 + hash<uint64_t>()(state.released);
-	for (size_t i = 0; i < state.num_valves; i++) {
-		result = result * 31 + hash<aoc::valve>()(state.valves[i]);
-	}
-	result = result * 31 + hash<size_t>()(state.num_valves);
-	for (size_t i = 0; i < state.num_agents; i++) {
-		result = result * 31 + hash<size_t>()(state.positions[i]);
-		result = result * 31 + hash<size_t>()(state.targets[i]);
-		result = result * 31 + hash<size_t>()(state.distances[i]);
-		result = result * 31 + hash<size_t>()(state.traveled[i]);
-	}
-	result = result * 31 + hash<size_t>()(state.num_agents);
-	return result;
+/**
+ * Reads the day 16 specific settings given using --option.
+ * Prints an error message for invalid values.
+ */
+void read_day16_settings() {
+	std::string_view value;
+	if (aoc::getSetting("visited_table_mib", value)) {
+		std::string_view rest = value;
+		if (!aoc::parse::number(rest, VISITED_TABLE_MIB) || !rest.empty()) {
+			std::cerr << "Invalid value \"" << value
+					<< "\" for setting \"visited_table_mib\"." << std::endl;
+		}
+	}
+
+	if (aoc::getSetting("agent_mode", value)) {
+		if (value == "subsets" || value == "joint") {
+			SUBSET_AGENTS = value == "subsets";
+		} else {
+			std::cerr << "Invalid value \"" << value
+					<< "\" for setting \"agent_mode\". Possible values are subsets and joint."
+					<< std::endl;
+		}
+	}
+
+	if (aoc::getSetting("search_threads", value)) {
+		std::string_view rest = value;
+		if (!aoc::parse::number(rest, SEARCH_THREADS) || !rest.empty()) {
+			std::cerr << "Invalid value \"" << value
+					<< "\" for setting \"search_threads\"." << std::endl;
+		}
+	}
+
+	if (aoc::getSetting("report_visited", value)) {
+		if (value == "true" || value == "false") {
+			REPORT_VISITED = value == "true";
+		} else {
+			std::cerr << "Invalid value \"" << value
+					<< "\" for setting \"report_visited\"." << std::endl;
+		}
+	}
 }
 
-std::pair<std::string, std::string> day16comb(std::ifstream input) {
+/**
+ * Gets the max number of entries a visited table for the given network should have.
+ * Gives each set of open valves one bucket, since states with the same open valves
+ * only differ in the positions and times of the agents.
+ * Larger tables only cost time to allocate, and cause more cache misses.
+ *
+ * @param network	The valve network the table is used for.
+ * @return	The max capacity of the visited table.
+ */
+size_t get_visited_capacity(const aoc::valve_network &network) {
+	// No table for this many valves could fit into memory anyway.
+	if (network.size >= 48) {
+		return SIZE_MAX;
+	}
+	return ((size_t) 1 << network.size) * VISITED_BUCKET_SIZE;
+}
+
+/**
+ * Prints the statistics of the given visited table, if REPORT_VISITED is set.
+ *
+ * @param visited	The table to print the statistics of. May be NULL.
+ * @param part		The part the table was used for.
+ */
+void report_visited(const aoc::visited_table *visited, const size_t part) {
+	if (!REPORT_VISITED || visited == NULL) {
+		return;
+	}
+
+	std::cout << "Part " << part << " visited table: capacity "
+			<< visited->get_capacity() << ", hits " << visited->get_hits()
+			<< ", misses " << visited->get_misses() << ", evictions "
+			<< visited->get_evictions() << '.' << std::endl;
+}
+
+std::pair<std::string, std::string> day16comb(aoc::input_stream input) {
+	read_day16_settings();
+
 	std::vector<aoc::valve> start_valves;
 	std::map<std::string, size_t> name_to_idx;
-	std::vector<std::vector<std::string>> connections;
-	std::string line;
-	while (std::getline(input, line)) {
-		if (line.length() == 0) {
-			continue;
+	{
+		aoc::phase parse_timer("parse");
+		std::vector<std::vector<std::string>> connections;
+		std::string line;
+		while (std::getline(input, line)) {
+			if (line.length() == 0) {
+				continue;
+			}
+
+			std::string name = line.substr(6, 2);
+			size_t semicolon = line.find(';');
+			uint8_t rate = std::stoi(line.substr(23, semicolon - 23));
+			start_valves.push_back(
+					aoc::valve(start_valves.size(), name, rate));
+			std::string conns = line.substr(semicolon + 24) + ',';
+			conns.erase(std::remove(conns.begin(), conns.end(), ' '),
+					conns.end());
+			name_to_idx.insert( { name, start_valves.size() - 1 });
+			std::vector<std::string> valve_conns;
+			while (conns.length() > 0) {
+				valve_conns.push_back(conns.substr(0, 2));
+				conns = conns.substr(3);
+			}
+			connections.push_back(valve_conns);
 		}
 
-		std::string name = line.substr(6, 2);
-		size_t semicolon = line.find(';');
-		uint8_t rate = std::stoi(line.substr(23, semicolon - 23));
-		start_valves.push_back(aoc::valve(start_valves.size(), name, rate));
-		std::string conns = line.substr(semicolon + 24) + ',';
-		conns.erase(std::remove(conns.begin(), conns.end(), ' '), conns.end());
-		name_to_idx.insert( { name, start_valves.size() - 1 });
-		std::vector<std::string> valve_conns;
-		while (conns.length() > 0) {
-			valve_conns.push_back(conns.substr(0, 2));
-			conns = conns.substr(3);
+		for (size_t i = 0; i < start_valves.size(); i++) {
+			for (std::string connection : connections[i]) {
+				start_valves[i] = start_valves[i].add_connection(
+						name_to_idx[connection]);
+			}
 		}
-		connections.push_back(valve_conns);
 	}
 
-	for (size_t i = 0; i < start_valves.size(); i++) {
-		for (std::string connection : connections[i]) {
-			start_valves[i] = start_valves[i].add_connection(
-					name_to_idx[connection]);
-		}
+	aoc::valve_network network;
+	{
+		aoc::phase network_timer("network");
+		network = aoc::build_network(start_valves, name_to_idx["AA"]);
+	}
+
+	aoc::phase search_timer("search");
+	// Reuse the pool of the runner, so running multiple days in parallel doesn't oversubscribe the CPU.
+	aoc::thread_pool *pool = aoc::thread_pool::get_current();
+	std::unique_ptr<aoc::thread_pool> own_pool;
+	if (SEARCH_THREADS == 1) {
+		pool = NULL;
+	} else if (pool == NULL) {
+		own_pool = std::make_unique<aoc::thread_pool>(SEARCH_THREADS);
+		pool = own_pool.get();
 	}
 
-	uint64_t part1 = aoc::get_max_released(start_valves, name_to_idx["AA"], 30,
-			1);
-	uint64_t part2 = aoc::get_max_released(start_valves, name_to_idx["AA"], 26,
-			2);
+	uint64_t part1 = aoc::get_max_released(network, 30, 1, NULL, pool);
+
+	uint64_t part2;
+	if (SUBSET_AGENTS) {
+		part2 = aoc::get_max_released_subsets(network, 26, 2);
+	} else {
+		std::unique_ptr<aoc::visited_table> visited;
+		if (VISITED_TABLE_MIB > 0) {
+			visited = std::make_unique<aoc::visited_table>(
+					get_visited_capacity(network), VISITED_TABLE_MIB << 20);
+		}
+		part2 = aoc::get_max_released(network, 26, 2, visited.get(), pool);
+		report_visited(visited.get(), 2);
+	}
 	return {std::to_string(part1), std::to_string(part2)};
 }
-
-bool d16c = aoc::registerCombined(16, &day16comb);
@@ -9,6 +9,9 @@
 #define DAY16_H_
 
 #include "Main.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <mutex>
 
 namespace aoc {
 /**
@@ -237,398 +240,361 @@ std::ostream& operator<<(std::ostream &stream, const valve &valve);
 void swap(valve &first, valve &second) noexcept;
 
 /**
- * An object representing the current state of a set of valves and connections.
- * Not internally const to allow assignment, but basically immutable.
+ * The max number of valves with a flow rate above 0 get_max_released supports.
+ * Limited by the number of bits in the open mask of search_state.
  */
-class state {
-private:
-	/**
-	 * The current rate at which pressure is released.
-	 */
-	uint64_t flow_rate;
-
-	/**
-	 * The amount of time that passed since the beginning.
-	 */
-	uint64_t time;
-
-	/**
-	 * The amount by which the pressure has reduced since the beginning.
-	 */
-	uint64_t released;
+constexpr size_t MAX_FLOW_VALVES = 64;
 
-	/**
-	 * All the valves to be tracked.
-	 */
-	valve *valves;
+/**
+ * The max number of agents get_max_released supports.
+ */
+constexpr size_t MAX_AGENTS = 4;
 
-	/**
-	 * The number of valves to be tracked.
-	 */
-	size_t num_valves;
+/**
+ * The max number of valves with a flow rate above 0 get_max_released_subsets supports.
+ * It stores one value for every subset of these valves.
+ */
+constexpr size_t MAX_SUBSET_VALVES = 24;
 
-	/**
-	 * The positions of the agents changing the valve states.
-	 */
-	size_t *positions;
+/**
+ * The size of a cache line, to which the rows of a distance_matrix are aligned.
+ */
+constexpr size_t CACHE_LINE_SIZE = 64;
 
+/**
+ * An immutable matrix of the shortest distances between a set of valves.
+ * Stored as a single flat array, with each row starting at a new cache line.
+ * Meant to be calculated once, and then shared by pointer.
+ */
+class distance_matrix {
+private:
 	/**
-	 * The target positions of the agents changing the valve states.
+	 * A single cache line of the matrix.
 	 */
-	size_t *targets;
+	struct alignas(CACHE_LINE_SIZE) cache_line {
+		/**
+		 * The distances stored in this cache line.
+		 */
+		uint8_t distances[CACHE_LINE_SIZE];
+	};
 
 	/**
-	 * The number of agents capable of changing the valve states.
-	 * The size of positions and targets.
+	 * The number of valves in this matrix, aka the number of rows and columns.
 	 */
-	size_t num_agents;
+	size_t size;
 
 	/**
-	 * The agents distance from their position to their target position.
-	 * Automatically updated, do not touch.
+	 * The number of cache lines per row.
 	 */
-	size_t *distances;
+	size_t row_lines;
 
 	/**
-	 * The distance the agents already traveled from their position towards their target position.
-	 * Automatically updated, do not touch.
+	 * The cache lines containing the distances.
 	 */
-	size_t *traveled;
+	std::vector<cache_line> lines;
 
 public:
 	/**
-	 * Creates a new state object with the given properties
+	 * Calculates the distances between the given valves, using a breadth first search from each of them.
+	 * Distances of unreachable valves, or above UINT8_MAX, are stored as UINT8_MAX.
 	 *
-	 * @param flow_rate		The rate at which pressure is currently released.
-	 * @param time			The current point in time represented by this state.
-	 * @param released		The amount of pressure released so far.
-	 * @param valves		An array of valves to track. May be NULL. Will be copied.
-	 * @param num_valves	The number of valves to track.
-	 * @param positions		An array of agent positions. May be NULL. Will be copied.
-	 * @param targets		An array of agent target positions. May be NULL. Will be copied.
-	 * @param num_agents	The size of both positions and targets.
+	 * @param valves	All the valves, including the ones that can only be traveled through.
+	 * @param nodes		The indices of the valves to calculate the distances between.
 	 */
-	state(const uint64_t flow_rate = 0, const uint64_t time = 0,
-			const uint64_t released = 0, const valve *valves = NULL,
-			const size_t num_valves = 0, const size_t *positions = NULL,
-			const size_t *targets = NULL, const size_t num_agents = 0);
+	distance_matrix(const std::vector<valve> &valves,
+			const std::vector<size_t> &nodes);
 
 	/**
-	 * A copy constructor.
-	 *
-	 * @param state	The state to copy.
-	 */
-	state(const state &state);
-
-	/**
-	 * A move constructor.
+	 * Gets the number of valves in this matrix.
 	 *
-	 * @param state	The state to move.
+	 * @return	The number of rows and columns of this matrix.
 	 */
-	state(state &&state) noexcept;
-
-	/**
-	 * A destructor deleting the underlying valves array.
-	 */
-	virtual ~state();
-
-	/**
-	 * An assignment operator.
-	 *
-	 * @param state	The state to set this state to.
-	 * @return the modified state.
-	 */
-	state& operator=(state state) noexcept;
-
-	/**
-	 * An equality check operator.
-	 *
-	 * @param other	The state to compare this state with.
-	 * @return	True if the states are equal, false otherwise.
-	 */
-	bool operator==(const state &other) const;
+	size_t get_size() const;
 
 	/**
-	 * An inequality check operator.
+	 * Gets the distances from the given valve to all valves in this matrix.
+	 * The returned row is aligned to a cache line.
 	 *
-	 * @param other	The state to compare this state with.
-	 * @return	False if the states are equal, true otherwise.
+	 * @param from	The index of the valve in the nodes this matrix was created with.
+	 * @return	A pointer to the first distance of the row.
 	 */
-	bool operator!=(const state &other) const;
+	const uint8_t* get_row(const size_t from) const;
 
 	/**
-	 * Creates a new state that represents this state when one unit of time passed.
-	 * Updates released pressure.
+	 * Gets the distance between the two given valves.
 	 *
-	 * @return	The updated state.
+	 * @param from	The index of the valve to start at.
+	 * @param to	The index of the valve to get the distance to.
+	 * @return	The distance from "from" to "to".
+	 * @throws std::out_of_range	If from or to is not less than the size of this matrix.
 	 */
-	state update() const;
+	uint8_t get_distance(const size_t from, const size_t to) const;
+};
 
+/**
+ * The valves with a flow rate above 0, and the distances between them.
+ * Valves without a flow rate are only ever traveled through, so they are only part of the distances.
+ */
+struct valve_network {
 	/**
-	 * Creates a new state that represents this state after a given amount of time passed.
-	 * Updates the released pressure, and moves all agents one step closer to their current target.
-	 * Also opens the target valve, if there is time left for that.
-	 *
-	 * @return	The new modified state.
+	 * The number of valves with a flow rate above 0.
+	 * Also the index of the start position in the distances matrix.
 	 */
-	state add_time(const uint64_t time) const;
+	size_t size;
 
 	/**
-	 * Adds the amount of time necessary for the first agent to reach his target and open the valve.
-	 * Unless that would be more than max_time, in which case only max_time is added.
-	 *
-	 * @param max_time	The max amount of time to add to the new state.
-	 * @return	The new modified state.
+	 * The flow rates of the valves with a flow rate above 0.
+	 * Sorted from the highest to the lowest flow rate.
 	 */
-	state run_to_nex_target(const uint64_t max_time) const;
+	std::vector<uint8_t> flow_rates;
 
 	/**
-	 * Gets the current rate at which pressure is released.
-	 *
-	 * @return	The current total flow rate.
+	 * The distances between the valves, as a (size + 1) * (size + 1) matrix.
+	 * Shared by all copies of this network.
 	 */
-	uint64_t get_flow_rate() const;
+	std::shared_ptr<const distance_matrix> distances;
+};
 
+/**
+ * The compact state of the search for the max amount of pressure that can be released.
+ * Doesn't reference any other memory, so it can be copied freely.
+ */
+struct search_state {
 	/**
-	 * Creates a new state with the given flow rate.
-	 *
-	 * @param flow_rate	The flow rate to use for the new copy of this state.
-	 * @return	The newly created state.
+	 * A bit mask of the valves that are open, or are going to be opened by an agent.
+	 * Bit N is set if the valve with index N in the valve_network is open.
 	 */
-	state set_flow_rate(const uint64_t flow_rate) const;
+	uint64_t open;
 
 	/**
-	 * Creates a new state, with this states flow rate plus the given flow rate.
-	 *
-	 * @param flow_rate	The flow rate to add.
-	 * @return	The new state object.
+	 * The total amount of pressure the opened valves release until the time runs out.
 	 */
-	state add_flow_rate(const uint64_t flow_rate) const;
+	uint32_t released;
 
 	/**
-	 * Returns the amount of time that passed since the first state was created.
-	 *
-	 * @return	The amount of time that passed.
+	 * The sum of the flow rates of the valves that aren't open yet.
+	 * Updated with the open mask, so the search can discard hopeless states without looking at the valves.
 	 */
-	uint64_t get_time() const;
+	uint16_t closed_flow;
 
 	/**
-	 * Gets the total amount of released pressure.
-	 *
-	 * @return	The released pressure.
+	 * The index of the valve each agent is at, or moving to.
+	 * The size of the valve_network if the agent is still at the start position.
 	 */
-	uint64_t get_released() const;
+	uint8_t positions[MAX_AGENTS];
 
 	/**
-	 * Gets the index of the valve at which the person controlling the valves is currently at.
-	 *
-	 * @param agent	The index of the agent whose position to get.
-	 * @return	The current position of the person controlling the valves.
-	 * @throws std::out_of_range	If agent is above the limit of the positions array.
+	 * The time at which each agent has opened the valve at its position.
 	 */
-	size_t get_position(const size_t agent) const;
+	uint8_t times[MAX_AGENTS];
+};
 
+/**
+ * A fixed size open addressing hash table of the search states that were already visited,
+ * and the max amount of pressure that was released when reaching them.
+ * Stores the full states, so unlike a set of hashes it never mistakes one state for another.
+ * Each state can only be stored in one bucket of entries, determined by its hash.
+ * When the bucket of a new state is full, one of its entries is evicted using the clock algorithm.
+ * Each bucket has its own clock hand, which skips and clears the entries of the bucket
+ * that were used since it last passed them.
+ * Can be used by multiple threads at once.
+ * Evicting an entry only causes a state to be searched again, so the results stay exact.
+ */
+class visited_table {
+private:
 	/**
-	 * Creates a new state object in which the position of the controller is the given position.
-	 * Resets the traveled distance, and recalculates the distance to the target.
-	 *
-	 * @param agent		The index of the agent whose position to set.
-	 * @param position	The new position for the agent.
-	 * @return	The new state object with the changed position.
-	 * @throws std::out_of_range	If agent is above the limit of the positions array,
-	 * 								or position is above the limit of the valves array.
+	 * A single entry of the table.
 	 */
-	state set_position(const size_t agent, const size_t position) const;
+	struct entry {
+		/**
+		 * The open mask of the stored state.
+		 */
+		uint64_t open;
 
-	/**
-	 * Gets the index of the target valve of the person controlling the valves.
-	 *
-	 * @param agent	The index of the agent whose target position to get.
-	 * @return	The target position of the given agent.
-	 * @throws std::out_of_range	If agent is above the limit of the targets array.
-	 */
-	size_t get_target(const size_t agent) const;
+		/**
+		 * The positions and times of the agents of the stored state.
+		 * Packed into a single integer, in a canonical order.
+		 */
+		uint64_t agents;
 
-	/**
-	 * Creates a new state object in which the target position of the given agent is the given position.
-	 * Also recalculates the distance to the target.
-	 *
-	 * @param agent	The index of the agent whose target position to set.
-	 * @param position	The target position for the agent.
-	 * @return	The new state object with the changed target position.
-	 * @throws std::out_of_range	If agent is above the limit of the targets array.
-	 * 								or position is above the limit of the valves array.
-	 */
-	state set_target(const size_t agent, const size_t position) const;
+		/**
+		 * The max amount of pressure released when reaching the stored state.
+		 */
+		uint32_t released;
 
-	/**
-	 * Returns the number of agents tracked by this state object.
-	 *
-	 * @return	The number of agents.
-	 */
-	size_t get_agents_count() const;
+		/**
+		 * Whether this entry contains a state.
+		 */
+		bool used;
 
-	/**
-	 * Gets the number of valves stored in this state.
-	 *
-	 * @return	The number of tracked valve states.
-	 */
-	size_t get_size() const;
+		/**
+		 * Whether this entry was used since the clock hand of its bucket last passed it.
+		 */
+		bool referenced;
+	};
 
 	/**
-	 * Returns the vector containing the valves this state monitors.
-	 *
-	 * @return	The vector containing the valve objects.
+	 * A lock protecting a subset of the buckets of the table, and their statistics.
+	 * Aligned to a cache line, so threads using different stripes don't slow each other down.
 	 */
-	const std::vector<valve> get_valves() const;
+	struct alignas(64) stripe {
+		/**
+		 * The mutex that has to be held to access the buckets of this stripe.
+		 */
+		std::mutex mutex;
 
-	/**
-	 * Gets the number of valves stored in this state.
-	 *
-	 * @return	The number of tracked valve states.
-	 */
-	size_t get_valves_count() const;
+		/**
+		 * The number of looked up states that were in the buckets of this stripe.
+		 */
+		uint64_t hits;
 
-	/**
-	 * Get the valve at the given index.
-	 *
-	 * @param index	The index of the valve to get.
-	 * @return	The valve at the given index.
-	 * @throws std::out_of_range	If index is greater than the biggest existing valve index.
-	 */
-	const valve& get_valve(const size_t index) const;
+		/**
+		 * The number of looked up states that were not in the buckets of this stripe.
+		 */
+		uint64_t misses;
 
-	/**
-	 * Creates a new state with the valve at the index of the given valve is replaced with the given valve.
-	 * If valve is equals to the size of the valves array, it is added to the and instead.
-	 *
-	 * @param valve	The new valve to use.
-	 * @return	The new modified state.
-	 * @throws std::out_of_range	If the index of valve is more than the size of the valves array.
-	 */
-	state set_valve(valve &valve) const;
+		/**
+		 * The number of entries of this stripe that were replaced by a new state.
+		 */
+		uint64_t evictions;
+	};
 
 	/**
-	 * Creates a new state with a new valve with the given properties added.
-	 *
-	 * @param name			The name of the new state to add.
-	 * @param flow_rate		The flow rate the new valve allows when it is open.
-	 * @param open			Whether the state to add is open already.
-	 * @param opened		The timem at which the given valve was opened.
-	 * @param connections	The indices of the valves the new valve is connected to.
-	 * @return	The newly created state.
+	 * The entries of this table. The size is always a power of two.
 	 */
-	state add_valve(const std::string name, const uint8_t flow_rate,
-			const bool open, const uint64_t opened,
-			std::vector<size_t> &connections) const;
+	std::vector<entry> entries;
 
 	/**
-	 * Checks whether the valve at the given index is open.
-	 *
-	 * @param index	The index of the valve to check.
-	 * @return	True if the valve is open.
-	 * @throws std::out_of_range	If index is outside the valves array.
+	 * The position of the clock hand of each bucket, within that bucket.
 	 */
-	bool valve_open(const size_t index) const;
+	std::vector<uint8_t> hands;
 
 	/**
-	 * Creates a copy of this state with the valve at the given index opened.
-	 * Returns an unmodified copy if the valve is already open.
-	 *
-	 * @param index	The index of the valve to open.
-	 * @return	The new modified state.
-	 * @throws std::out_of_range	If index is outside the valves array.
+	 * The locks protecting the buckets of this table.
+	 * Bucket N is protected by stripe N % VISITED_STRIPES.
 	 */
-	state open_valve(const size_t index) const;
+	std::unique_ptr<stripe[]> stripes;
 
+public:
 	/**
-	 * Gets the flow rate of the valve at the given index.
+	 * Creates a new visited table with at most the given number of entries,
+	 * using at most the given amount of memory.
+	 * The number of entries is rounded down to a power of two.
 	 *
-	 * @param index	The index of the valve to check.
-	 * @return	The flow rate the given valve allows when it is open.
-	 * @throws std::out_of_range	If index is outside the valves array.
+	 * @param max_capacity	The max number of entries of this table.
+	 * @param memory		The max number of bytes to use for the entries and clock hands of this table.
 	 */
-	uint8_t get_valve_flow_rate(const size_t index) const;
+	visited_table(const size_t max_capacity, const size_t memory);
 
 	/**
-	 * Gets the indices of the valves the valve at the given index is connected to.
+	 * Checks whether the given state was already reached with at least as much released pressure.
+	 * If not, stores the given state in this table.
 	 *
-	 * @param index	The index of the valve to check.
-	 * @return The connections vector of the given valve.
-	 * @throws std::out_of_range	If index is outside the valves array.
+	 * @param state			The state to check.
+	 * @param num_agents	The number of agents of the state.
+	 * @return	True if the given state doesn't have to be searched again.
 	 */
-	const std::vector<size_t> get_valve_connections(const size_t index) const;
+	bool check(const search_state &state, const size_t num_agents);
 
 	/**
-	 * Calculates the distance between the two given positions.
+	 * Gets the max number of states this table can store.
 	 *
-	 * @param from	The position from which to start.
-	 * @param to	The position to which to find the distance.
-	 * @return	The distance from "from" to "to".
-	 * @throws std::out_of_range	If from or to is outside of the valves array.
+	 * @return	The number of entries of this table.
 	 */
-	size_t get_distance(const size_t from, const size_t to) const;
+	size_t get_capacity() const;
 
 	/**
-	 * Gets the distance from the current position of the given agent to its target position.
+	 * Gets the number of looked up states that were already in this table.
 	 *
-	 * @param agent	The index of the agent to calculate the distance for.
-	 * @return	The distance from the current position to the given target position.
-	 * @throws std::out_of_range	If the agent index is outside the positions array.
+	 * @return	The number of table hits.
 	 */
-	size_t get_distance_to_target(const size_t agent) const;
+	uint64_t get_hits() const;
 
 	/**
-	 * Prints this state to the given output straem.
+	 * Gets the number of looked up states that weren't yet in this table.
 	 *
-	 * @param stream	The ostream to write this state to.
-	 * @param multiline	Whether to write this state in a multiline format, rather than a single line.
+	 * @return	The number of table misses.
 	 */
-	void print_to(std::ostream &stream, const bool multiline = false) const;
+	uint64_t get_misses() const;
 
 	/**
-	 * Writes the given state to the given output stream.
+	 * Gets the number of stored states that were replaced because the table was full.
 	 *
-	 * @param stream	The stream to write to state to.
-	 * @param state		The state to write to the given output stream.
-	 * @return	The modified stream object.
+	 * @return	The number of evicted entries.
 	 */
-	friend std::ostream& operator<<(std::ostream &stream,
-			const aoc::state &state);
+	uint64_t get_evictions() const;
+};
 
-	/**
-	 * Swaps the given two state instances.
-	 *
-	 * @param first		The first of the two states to swap.
-	 * @param second	The second of the two states to swap.
-	 */
-	friend void swap(state &first, state &second) noexcept;
+/**
+ * Compresses the given valves to the valves with a flow rate above 0,
+ * and calculates the distances between them and from the start position.
+ *
+ * @param valves	The valve structure to compress.
+ * @param start_pos	The index of the valve at which the agents start.
+ * @return	The compressed valve network.
+ * @throws std::invalid_argument	If there are more than MAX_FLOW_VALVES valves with a flow rate.
+ */
+valve_network build_network(const std::vector<valve> &valves,
+		const size_t start_pos);
 
-	/**
-	 * The struct housing the function generating a hash for a valve object.
-	 */
-	friend struct std::hash<state>;
-};
+/**
+ * Tests the max amount of pressure that can be released in the given amount of time.
+ * Uses a depth first search over compact search_states, that doesn't allocate memory.
+ *
+ * @param network		The compressed valve network to use.
+ * @param time			The time for which to test.
+ * @param num_agents	The number of agents that can open valves.
+ * @param visited		The table to skip states that were already visited with.
+ * 						Has to be empty, or only be used with the same arguments before.
+ * 						May be NULL to not skip any states.
+ * @param pool			The thread pool to search on. May be NULL to search on the calling thread.
+ * 						If set, the states after the first moves are searched by the calling thread
+ * 						and tasks of the pool, which share the best result found so far to prune their states.
+ * 						May be the pool the calling thread is a worker of,
+ * 						since the calling thread never runs other tasks while waiting.
+ * @return	The max amount of pressure that can be released.
+ * @throws std::invalid_argument	If num_agents is 0 or more than MAX_AGENTS,
+ * 									or time is more than UINT8_MAX.
+ */
+uint64_t get_max_released(const valve_network &network, const size_t time,
+		const size_t num_agents, visited_table *visited = NULL,
+		thread_pool *pool = NULL);
 
 /**
- * Writes the given state to the given output stream.
+ * Calculates the max amount of pressure a single agent can release in the given amount of time,
+ * for every subset of the valves with a flow rate above 0.
+ * Afterwards the value of each subset is the max of the values of all of its subsets,
+ * so it is the max amount of pressure that can be released opening only valves from that subset.
  *
- * @param stream	The stream to write to state to.
- * @param state		The state to write to the given output stream.
- * @return	The modified stream object.
+ * @param network	The compressed valve network to use.
+ * @param time		The time for which to test.
+ * @return	The max released pressure for each subset, indexed by the subsets open mask.
+ * @throws std::invalid_argument	If the network has more than MAX_SUBSET_VALVES valves,
+ * 									or time is more than UINT8_MAX.
  */
-std::ostream& operator<<(std::ostream &stream, const aoc::state &state);
+std::vector<uint32_t> get_max_released_per_subset(
+		const valve_network &network, const size_t time);
 
 /**
- * Swaps the given two state instances.
+ * Tests the max amount of pressure that can be released in the given amount of time.
+ * Rather than searching the moves of all agents at once, this assigns each agent
+ * a disjoint subset of the valves, using the results of get_max_released_per_subset.
+ * The last agent is combined with a single pass over all subsets,
+ * while each additional agent requires a pass over all pairs of disjoint subsets.
  *
- * @param first		The first of the two states to swap.
- * @param second	The second of the two states to swap.
+ * @param network		The compressed valve network to use.
+ * @param time			The time for which to test.
+ * @param num_agents	The number of agents that can open valves.
+ * @return	The max amount of pressure that can be released.
+ * @throws std::invalid_argument	If num_agents is 0, the network has more than MAX_SUBSET_VALVES
+ * 									valves, or time is more than UINT8_MAX.
  */
-void swap(state &first, state &second) noexcept;
+uint64_t get_max_released_subsets(const valve_network &network,
+		const size_t time, const size_t num_agents);
 
 /**
  * Tests the max amount of pressure that can be released in the given amount of time.
+ * Compresses the valves using build_network first.
  *
  * @param valves		The valve structure to be used.
  * @param start_pos		The starting position of all the agents.
@@ -636,8 +602,8 @@ void swap(state &first, state &second) noexcept;
  * @param num_agents	The number of agents that can open valves.
  * @return	The max amount of pressure that can be released.
  */
-uint64_t get_max_released(std::vector<valve> valves, size_t start_pos,
-		size_t time, size_t num_agents);
+uint64_t get_max_released(const std::vector<valve> &valves,
+		const size_t start_pos, const size_t time, const size_t num_agents);
 }
 
 namespace std {
@@ -654,20 +620,6 @@ struct hash<aoc::valve> {
 	 */
 	size_t operator()(const aoc::valve &valve) const noexcept;
 };
-
-/**
- * The struct housing the function generating a hash for a state object.
- */
-template<>
-struct hash<aoc::state> {
-	/**
-	 * Calculates a hash value representing the given state.
-	 *
-	 * @param state	The state to hash.
-	 * @return	The hash for the given state.
-	 */
-	size_t operator()(const aoc::state &state) const noexcept;
-};
 }
 
 #endif /* DAY16_H_ */
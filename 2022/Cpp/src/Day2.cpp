@@ -7,7 +7,7 @@
 
 #include "Main.h"
 
-std::string day2part1(std::ifstream input) {
+std::string day2part1(aoc::input_stream input) {
 	uint32_t score = 0;
 	std::string line;
 	while (std::getline(input, line)) {
@@ -28,7 +28,7 @@ std::string day2part1(std::ifstream input) {
 	return std::to_string(score);
 }
 
-std::string day2part2(std::ifstream input) {
+std::string day2part2(aoc::input_stream input) {
 	uint32_t score = 0;
 	std::string line;
 	while (std::getline(input, line)) {
@@ -42,6 +42,3 @@ std::string day2part2(std::ifstream input) {
 
 	return std::to_string(score);
 }
-
-bool d2p1 = aoc::registerPart1(2, &day2part1);
-bool d2p2 = aoc::registerPart2(2, &day2part2);
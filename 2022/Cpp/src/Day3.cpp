@@ -7,15 +7,11 @@
 
 #include "Main.h"
 
-std::string day3part1(std::ifstream input) {
+std::string day3part1(aoc::input_stream input) {
 	uint32_t sum = 0;
 
-	std::string line;
-	while (std::getline(input, line)) {
+	for (const std::string_view line : aoc::line_range(input.view(), true)) {
 		const size_t len = line.length();
-		if (len == 0) {
-			continue;
-		}
 
 		const size_t end1 = line.length() / 2;
 		uint64_t first = 0;
@@ -34,17 +30,12 @@ std::string day3part1(std::ifstream input) {
 	return std::to_string(sum);
 }
 
-std::string day3part2(std::ifstream input) {
+std::string day3part2(aoc::input_stream input) {
 	uint32_t sum = 0;
 
 	uint64_t options = 0;
 	size_t ln = 0;
-	std::string line;
-	while (std::getline(input, line)) {
-		if (line.length() == 0) {
-			continue;
-		}
-
+	for (const std::string_view line : aoc::line_range(input.view(), true)) {
 		uint64_t newopts = 0;
 		for (char c : line) {
 			newopts |= (1ll << (c > 'Z' ? c - 'a' : c - 'A' + 26));
@@ -70,6 +61,3 @@ std::string day3part2(std::ifstream input) {
 
 	return std::to_string(sum);
 }
-
-bool d3p1 = aoc::registerPart1(3, &day3part1);
-bool d3p2 = aoc::registerPart2(3, &day3part2);
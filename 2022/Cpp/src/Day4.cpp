@@ -7,7 +7,7 @@
 
 #include "Main.h"
 
-std::pair<std::string, std::string> day4Combined(std::ifstream input) {
+std::pair<std::string, std::string> day4Combined(aoc::input_stream input) {
 	uint16_t useless = 0;
 	uint16_t overlapping = 0;
 
@@ -40,5 +40,3 @@ std::pair<std::string, std::string> day4Combined(std::ifstream input) {
 
 	return {std::to_string(useless), std::to_string(overlapping)};
 }
-
-bool d4c = aoc::registerCombined(4, &day4Combined);
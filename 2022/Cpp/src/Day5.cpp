@@ -6,9 +6,10 @@
  */
 
 #include "Main.h"
+#include <algorithm>
 #include <sstream>
 
-std::pair<std::string, std::string> day5Combined(std::ifstream input) {
+std::pair<std::string, std::string> day5Combined(aoc::input_stream input) {
 	std::vector<std::vector<uint8_t>> crates;
 	std::vector<std::vector<uint8_t>> crates2;
 	std::string line;
@@ -80,5 +81,3 @@ std::pair<std::string, std::string> day5Combined(std::ifstream input) {
 
 	return {result1.str(), result2.str()};
 }
-
-bool d5c = aoc::registerCombined(5, &day5Combined);
@@ -7,7 +7,7 @@
 
 #include "Main.h"
 
-std::string day6part1(std::ifstream input) {
+std::string day6part1(aoc::input_stream input) {
 	std::string line;
 	while (input >> line && line.length() == 0);
 
@@ -47,7 +47,7 @@ std::string day6part1(std::ifstream input) {
 	return std::to_string(result);
 }
 
-std::string day6part2(std::ifstream input) {
+std::string day6part2(aoc::input_stream input) {
 	std::string line;
 	while (input >> line && line.length() == 0);
 
@@ -86,6 +86,3 @@ std::string day6part2(std::ifstream input) {
 
 	return std::to_string(result);
 }
-
-bool p6d1 = aoc::registerPart1(6, &day6part1);
-bool p6d2 = aoc::registerPart2(6, &day6part2);
@@ -87,7 +87,7 @@ std::ostream& operator<<(std::ostream &stream, const aoc::FSNode &node) {
 	return stream;
 }
 
-std::pair<std::string, std::string> day7Combined(std::ifstream input) {
+std::pair<std::string, std::string> day7Combined(aoc::input_stream input) {
 	aoc::FSNode *root = new aoc::FSNode(NULL, "/", 0, true);
 	aoc::FSNode *current = root;
 
@@ -182,5 +182,3 @@ std::pair<std::string, std::string> day7Combined(std::ifstream input) {
 
 	return {std::to_string(part1sum), std::to_string(min)};
 }
-
-bool d7c = aoc::registerCombined(7, &day7Combined);
@@ -9,6 +9,7 @@
 #define DAY7_H_
 
 #include "Main.h"
+#include <unordered_map>
 
 namespace aoc {
 
@@ -7,7 +7,7 @@
 
 #include "Main.h"
 
-std::pair<std::string, std::string> day8combined(std::ifstream input) {
+std::pair<std::string, std::string> day8combined(aoc::input_stream input) {
 	std::vector<std::vector<uint8_t>> map;
 	std::string line;
 	size_t ln = 0;
@@ -99,5 +99,3 @@ std::pair<std::string, std::string> day8combined(std::ifstream input) {
 
 	return {std::to_string(visible), std::to_string(best_scenic)};
 }
-
-bool d8c = aoc::registerCombined(8, &day8combined);
@@ -8,7 +8,7 @@
 #include "Main.h"
 #include "set"
 
-std::string day9part1(std::ifstream input) {
+std::string day9part1(aoc::input_stream input) {
 	std::set<std::pair<int32_t, int32_t>> visited_positions;
 	std::string line;
 	std::pair<int32_t, int32_t> head_pos = { 0, 0 };
@@ -70,7 +70,7 @@ std::string day9part1(std::ifstream input) {
 	return std::to_string(visited_positions.size());
 }
 
-std::string day9part2(std::ifstream input) {
+std::string day9part2(aoc::input_stream input) {
 	std::set<std::pair<int32_t, int32_t>> visited_positions;
 	std::string line;
 	std::pair<int32_t, int32_t> positions[10] = { { 0, 0 } };
@@ -135,6 +135,3 @@ std::string day9part2(std::ifstream input) {
 
 	return std::to_string(visited_positions.size());
 }
-
-bool d9p1 = aoc::registerPart1(9, &day9part1);
-bool d9p2 = aoc::registerPart2(9, &day9part2);
@@ -8,10 +8,13 @@
 #ifndef MAIN_H_
 #define MAIN_H_
 
-#include <functional>
-#include <fstream>
+#include "Input.h"
+#include "Lines.h"
+#include "Runner.h"
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 /**
  * The main method that gets called when the program is executed.
@@ -22,80 +25,212 @@
  */
 int main(int argc, char *argv[]);
 
-namespace aoc {
-/*
- * Gets a file input stream for the input file for the given day.
- * Ends the program if the file can't be found.
+/**
+ * Solves both parts of day 1.
+ *
+ * @param input	The input for day 1.
+ * @return	The results of part 1 and part 2.
+ */
+std::pair<std::string, std::string> day1comb(aoc::input_stream input);
+
+/**
+ * Solves part 1 of day 2.
+ *
+ * @param input	The input for day 2.
+ * @return	The result of part 1.
+ */
+std::string day2part1(aoc::input_stream input);
+
+/**
+ * Solves part 2 of day 2.
+ *
+ * @param input	The input for day 2.
+ * @return	The result of part 2.
+ */
+std::string day2part2(aoc::input_stream input);
+
+/**
+ * Solves part 1 of day 3.
+ *
+ * @param input	The input for day 3.
+ * @return	The result of part 1.
+ */
+std::string day3part1(aoc::input_stream input);
+
+/**
+ * Solves part 2 of day 3.
+ *
+ * @param input	The input for day 3.
+ * @return	The result of part 2.
+ */
+std::string day3part2(aoc::input_stream input);
+
+/**
+ * Solves both parts of day 4.
+ *
+ * @param input	The input for day 4.
+ * @return	The results of part 1 and part 2.
+ */
+std::pair<std::string, std::string> day4Combined(aoc::input_stream input);
+
+/**
+ * Solves both parts of day 5.
+ *
+ * @param input	The input for day 5.
+ * @return	The results of part 1 and part 2.
+ */
+std::pair<std::string, std::string> day5Combined(aoc::input_stream input);
+
+/**
+ * Solves part 1 of day 6.
+ *
+ * @param input	The input for day 6.
+ * @return	The result of part 1.
+ */
+std::string day6part1(aoc::input_stream input);
+
+/**
+ * Solves part 2 of day 6.
+ *
+ * @param input	The input for day 6.
+ * @return	The result of part 2.
+ */
+std::string day6part2(aoc::input_stream input);
+
+/**
+ * Solves both parts of day 7.
+ *
+ * @param input	The input for day 7.
+ * @return	The results of part 1 and part 2.
+ */
+std::pair<std::string, std::string> day7Combined(aoc::input_stream input);
+
+/**
+ * Solves both parts of day 8.
+ *
+ * @param input	The input for day 8.
+ * @return	The results of part 1 and part 2.
+ */
+std::pair<std::string, std::string> day8combined(aoc::input_stream input);
+
+/**
+ * Solves part 1 of day 9.
+ *
+ * @param input	The input for day 9.
+ * @return	The result of part 1.
+ */
+std::string day9part1(aoc::input_stream input);
+
+/**
+ * Solves part 2 of day 9.
+ *
+ * @param input	The input for day 9.
+ * @return	The result of part 2.
+ */
+std::string day9part2(aoc::input_stream input);
+
+/**
+ * Solves part 1 of day 10.
  *
- * @param day	The day for which to get the input stream.
- * @return	A ifstream for the input file for the given day.
+ * @param input	The input for day 10.
+ * @return	The result of part 1.
  */
-std::ifstream getInputFileStream(const uint8_t day);
+std::string day10part1(aoc::input_stream input);
 
 /**
- * Reads all lines from the given input stream and returns a vector containing them all.
+ * Solves part 2 of day 10.
  *
- * @param input	The file to read the lines from.
- * @return	A vector containing each non-empty line as separate string.
+ * @param input	The input for day 10.
+ * @return	The result of part 2.
  */
-std::vector<std::string> readLines(std::ifstream &input);
+std::string day10part2(aoc::input_stream input);
 
 /**
- * Prints the help text for this program to the given output stream.
+ * Solves part 1 of day 11.
  *
- * @param out	The output stream to print the usage to.
- * @param file	The current execution path of this process.
+ * @param input	The input for day 11.
+ * @return	The result of part 1.
  */
-void printUsage(std::ostream &out, const char *file);
+std::string day11part1(aoc::input_stream input);
 
 /**
- * Formats the given time in microseconds to the given output stream.
+ * Solves part 2 of day 11.
  *
- * @param out		The output stream to print the time to.
- * @param time_us	The time to print to the stream.
+ * @param input	The input for day 11.
+ * @return	The result of part 2.
  */
-void formatTime(std::ostream &out, const uint64_t time_us);
+std::string day11part2(aoc::input_stream input);
 
 /**
- * A std::function object representing a function that solves a single part of a single day.
+ * Solves part 1 of day 12.
+ *
+ * @param input	The input for day 12.
+ * @return	The result of part 1.
+ */
+std::string day12part1(aoc::input_stream input);
+
+/**
+ * Solves part 2 of day 12.
+ *
+ * @param input	The input for day 12.
+ * @return	The result of part 2.
+ */
+std::string day12part2(aoc::input_stream input);
+
+/**
+ * Solves part 1 of day 13.
+ *
+ * @param input	The input for day 13.
+ * @return	The result of part 1.
  */
-typedef std::function<std::string(std::ifstream input)> part_func;
+std::string day13part1(aoc::input_stream input);
 
 /**
- * A std::function representing a function that solves both parts of a challenge.
+ * Solves part 2 of day 13.
+ *
+ * @param input	The input for day 13.
+ * @return	The result of part 2.
+ */
+std::string day13part2(aoc::input_stream input);
+
+/**
+ * Solves part 1 of day 14.
+ *
+ * @param input	The input for day 14.
+ * @return	The result of part 1.
+ */
+std::string day14part1(aoc::input_stream input);
+
+/**
+ * Solves part 2 of day 14.
+ *
+ * @param input	The input for day 14.
+ * @return	The result of part 2.
  */
-typedef std::function<std::pair<std::string, std::string>(std::ifstream input)> combined_func;
+std::string day14part2(aoc::input_stream input);
 
 /**
- * Registers the given function as a part 1 solution to the challenge for the given day.
- * Prints an error message and terminates the program if a part 1 function is already registered for the given day.
+ * Solves part 1 of day 15.
  *
- * @param day	The day to register the function for.
- * @param func	The function to register.
- * @return	Whether the function was successfully registered. Always true since it terminates the program otherwise.
+ * @param input	The input for day 15.
+ * @return	The result of part 1.
  */
-bool registerPart1(const uint8_t day, const part_func &func);
+std::string day15part1(aoc::input_stream input);
 
 /**
- * Registers the given function as a part 2 solution to the challenge for the given day.
- * Prints an error message and terminates the program if a part 2 function is already registered for the given day.
+ * Solves part 2 of day 15.
  *
- * @param day	The day to register the function for.
- * @param func	The function to register.
- * @return	Whether the function was successfully registered. Always true since it terminates the program otherwise.
+ * @param input	The input for day 15.
+ * @return	The result of part 2.
  */
-bool registerPart2(const uint8_t day, const part_func &func);
+std::string day15part2(aoc::input_stream input);
 
 /**
- * Registers a combined part 1 and two function for the given day.
- * Prints an error message and terminates the program if a part 1 or 2 function
- * is already registered for the given day.
+ * Solves both parts of day 16.
  *
- * @param day	The day to register the function for.
- * @param func	The function to register.
- * @return	Whether the function was successfully registered. Always true since it terminates the program otherwise.
+ * @param input	The input for day 16.
+ * @return	The results of part 1 and part 2.
  */
-bool registerCombined(const uint8_t day, const combined_func &func);
-}
+std::pair<std::string, std::string> day16comb(aoc::input_stream input);
 
 #endif /* MAIN_H_ */
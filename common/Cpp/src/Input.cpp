@@ -0,0 +1,166 @@
+/*
+ * Input.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#include "Input.h"
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+aoc::input_buffer::input_buffer(const std::string_view data) {
+	// The get area is never written to, so casting away the const is safe.
+	char *begin = const_cast<char*>(data.data());
+	setg(begin, begin, begin + data.length());
+}
+
+aoc::input_buffer::pos_type aoc::input_buffer::seekoff(off_type off,
+		std::ios_base::seekdir dir, std::ios_base::openmode which) {
+	if (!(which & std::ios_base::in)) {
+		return pos_type(off_type(-1));
+	}
+
+	off_type pos = off;
+	if (dir == std::ios_base::cur) {
+		pos += gptr() - eback();
+	} else if (dir == std::ios_base::end) {
+		pos += egptr() - eback();
+	}
+
+	if (pos < 0 || pos > egptr() - eback()) {
+		return pos_type(off_type(-1));
+	}
+
+	setg(eback(), eback() + pos, egptr());
+	return pos_type(pos);
+}
+
+aoc::input_buffer::pos_type aoc::input_buffer::seekpos(pos_type pos,
+		std::ios_base::openmode which) {
+	return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+aoc::input_stream::input_stream(const std::string_view data) :
+		std::istream(NULL), buffer(data), data(data) {
+	rdbuf(&buffer);
+}
+
+aoc::input_stream::input_stream(input_stream &&stream) :
+		std::istream(std::move(stream)), buffer(stream.buffer), data(
+				stream.data) {
+	set_rdbuf(&buffer);
+}
+
+std::string_view aoc::input_stream::view() const {
+	return data;
+}
+
+std::filesystem::path aoc::getInputFilePath(const uint8_t day) {
+	namespace fs = std::filesystem;
+
+	fs::path input("..");
+	input += fs::path::preferred_separator;
+	input += "input";
+	if (!fs::exists(input)) {
+		std::cerr << "Directory " << input.generic_string() << " doesn't exist."
+				<< std::endl;
+		exit(2);
+	}
+	input = fs::canonical(input);
+
+	if (!fs::is_directory(input)) {
+		std::cerr << "File " << input.generic_string() << " is not a directory."
+				<< std::endl;
+		exit(2);
+	}
+
+	input += fs::path::preferred_separator;
+	input += "Day";
+	input += std::to_string(day);
+	input += ".txt";
+	if (!fs::exists(input) || !fs::is_regular_file(input)) {
+		std::cerr << "File " << input.generic_string()
+				<< " doesn't exist or isn't a file." << std::endl;
+		exit(3);
+	}
+
+	return input;
+}
+
+/**
+ * Reads the file at the given path into memory, without ever releasing it.
+ * Memory maps the file where that is supported.
+ * Ends the program if the file can't be read.
+ *
+ * @param path	The path of the file to read.
+ * @return	A view of the file contents, valid until the program exits.
+ */
+std::string_view loadFile(const std::filesystem::path &path) {
+#if defined(__unix__) || defined(__APPLE__)
+	const int fd = open(path.c_str(), O_RDONLY);
+	struct stat stats;
+	if (fd < 0 || fstat(fd, &stats) != 0) {
+		std::cerr << "Failed to open file " << path.generic_string() << '.'
+				<< std::endl;
+		exit(3);
+	}
+
+	// Mapping an empty file fails, but there is nothing to read anyway.
+	if (stats.st_size == 0) {
+		close(fd);
+		return std::string_view();
+	}
+
+	void *data = mmap(NULL, stats.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		std::cerr << "Failed to map file " << path.generic_string() << '.'
+				<< std::endl;
+		exit(3);
+	}
+	return std::string_view(static_cast<const char*>(data), stats.st_size);
+#else
+	std::ifstream file(path, std::ios_base::binary);
+	if (!file) {
+		std::cerr << "Failed to open file " << path.generic_string() << '.'
+				<< std::endl;
+		exit(3);
+	}
+
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	// Intentionally never freed, like the memory mapping on other platforms.
+	const std::string *data = new std::string(contents.str());
+	return std::string_view(*data);
+#endif
+}
+
+std::string_view aoc::getInput(const uint8_t day) {
+	static std::once_flag loaded[26];
+	static std::string_view inputs[26];
+
+	if (day > 25) {
+		std::cerr << "Can't get the input for day " << (uint16_t) day
+				<< " because it isn't a valid day." << std::endl;
+		exit(3);
+	}
+
+	std::call_once(loaded[day], [day]() {
+		inputs[day] = loadFile(getInputFilePath(day));
+	});
+	return inputs[day];
+}
+
+aoc::input_stream aoc::getInputStream(const uint8_t day) {
+	return input_stream(getInput(day));
+}
@@ -0,0 +1,133 @@
+/*
+ * Input.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#ifndef INPUT_H_
+#define INPUT_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <streambuf>
+#include <string_view>
+
+namespace aoc {
+/**
+ * A read-only stream buffer reading from an existing block of memory.
+ * Does not copy or own the memory.
+ */
+class input_buffer: public std::streambuf {
+public:
+	/**
+	 * Creates a new stream buffer reading the given characters.
+	 *
+	 * @param data	The characters to read. Have to outlive this buffer.
+	 */
+	explicit input_buffer(const std::string_view data);
+
+	/**
+	 * A copy constructor.
+	 * The new buffer reads the same memory, starting at the current position of the given buffer.
+	 *
+	 * @param buffer	The buffer to copy.
+	 */
+	input_buffer(const input_buffer &buffer) = default;
+
+protected:
+	/**
+	 * Changes the read position relative to the beginning, end, or current read position.
+	 *
+	 * @param off	The offset to move the read position by.
+	 * @param dir	The position the offset is relative to.
+	 * @param which	The positions to change. Has to include std::ios_base::in.
+	 * @return	The new read position, or -1 if it would be outside the buffer.
+	 */
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+			std::ios_base::openmode which = std::ios_base::in) override;
+
+	/**
+	 * Sets the read position to the given absolute position.
+	 *
+	 * @param pos	The new read position.
+	 * @param which	The positions to change. Has to include std::ios_base::in.
+	 * @return	The new read position, or -1 if it would be outside the buffer.
+	 */
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which =
+			std::ios_base::in) override;
+};
+
+/**
+ * An input stream reading the cached contents of an input file.
+ * Can be used like the std::ifstream previously given to the solvers,
+ * but never copies the file contents, and gives direct access to them through view().
+ */
+class input_stream: public std::istream {
+private:
+	/**
+	 * The stream buffer reading the input data.
+	 */
+	input_buffer buffer;
+
+	/**
+	 * The full input data read by this stream.
+	 */
+	std::string_view data;
+
+public:
+	/**
+	 * Creates a new input stream reading the given characters.
+	 *
+	 * @param data	The characters to read. Have to outlive this stream.
+	 */
+	explicit input_stream(const std::string_view data);
+
+	/**
+	 * A move constructor.
+	 *
+	 * @param stream	The stream to move.
+	 */
+	input_stream(input_stream &&stream);
+
+	/**
+	 * Gets the full input data of this stream.
+	 * Independent of the current read position.
+	 *
+	 * @return	A view of the full input data.
+	 */
+	std::string_view view() const;
+};
+
+/**
+ * Gets the path of the input file for the given day.
+ * Ends the program if the file can't be found.
+ *
+ * @param day	The day for which to get the input file.
+ * @return	The canonical path of the input file for the given day.
+ */
+std::filesystem::path getInputFilePath(const uint8_t day);
+
+/**
+ * Gets the contents of the input file for the given day.
+ * The file is memory mapped the first time this is called for a day,
+ * later calls return the same mapping. Thread safe.
+ * Ends the program if the file can't be found or read.
+ *
+ * @param day	The day for which to get the input.
+ * @return	A read-only view of the input file, valid until the program exits.
+ */
+std::string_view getInput(const uint8_t day);
+
+/**
+ * Creates a new input stream reading the cached input for the given day.
+ * Ends the program if the file can't be found or read.
+ *
+ * @param day	The day for which to get the input stream.
+ * @return	A new stream reading the input for the given day from the start.
+ */
+input_stream getInputStream(const uint8_t day);
+}
+
+#endif /* INPUT_H_ */
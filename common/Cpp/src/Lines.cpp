@@ -0,0 +1,40 @@
+/*
+ * Lines.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#include "Lines.h"
+#include <cstring>
+
+const char* aoc::find_newline(const char *begin, const char *end) {
+	// glibc and most other C libraries already pick a vectorized memchr for the current CPU at runtime.
+	const void *newline = std::memchr(begin, '\n', end - begin);
+	return newline == NULL ? end : static_cast<const char*>(newline);
+}
+
+aoc::line_iterator::line_iterator() :
+		next(NULL), last(NULL), skip_empty(false) {
+}
+
+aoc::line_iterator::line_iterator(const std::string_view text,
+		const bool skip_empty) :
+		next(text.data()), last(text.data() + text.length()), skip_empty(
+				skip_empty) {
+	advance();
+}
+
+void aoc::line_iterator::advance() {
+	do {
+		if (next == last) {
+			next = NULL;
+			line = std::string_view();
+			return;
+		}
+
+		const char *newline = find_newline(next, last);
+		line = std::string_view(next, newline - next);
+		next = newline == last ? last : newline + 1;
+	} while (skip_empty && line.empty());
+}
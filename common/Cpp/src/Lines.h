@@ -0,0 +1,144 @@
+/*
+ * Lines.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#ifndef LINES_H_
+#define LINES_H_
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+namespace aoc {
+/**
+ * Finds the first newline character in the given range.
+ *
+ * @param begin	A pointer to the first character to check.
+ * @param end	A pointer to the character after the last one to check.
+ * @return	A pointer to the first newline, or end if there is none.
+ */
+const char* find_newline(const char *begin, const char *end);
+
+/**
+ * A forward iterator over the lines of a block of text.
+ * The lines are views into the text, so iterating never allocates.
+ * Lines don't include their newline character.
+ */
+class line_iterator {
+private:
+	/**
+	 * The start of the line after the current one.
+	 * NULL for the end iterator.
+	 */
+	const char *next;
+
+	/**
+	 * The end of the text to iterate.
+	 */
+	const char *last;
+
+	/**
+	 * Whether empty lines should be skipped.
+	 */
+	bool skip_empty;
+
+	/**
+	 * The current line.
+	 */
+	std::string_view line;
+
+	/**
+	 * Moves this iterator to the next line, or the end if there is none.
+	 */
+	void advance();
+
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef std::string_view value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const std::string_view *pointer;
+	typedef const std::string_view &reference;
+
+	/**
+	 * Creates a new end iterator.
+	 */
+	line_iterator();
+
+	/**
+	 * Creates a new iterator pointing to the first line of the given text.
+	 *
+	 * @param text			The text to iterate. Has to outlive this iterator.
+	 * @param skip_empty	Whether empty lines should be skipped.
+	 */
+	line_iterator(const std::string_view text, const bool skip_empty);
+
+	reference operator*() const {
+		return line;
+	}
+
+	pointer operator->() const {
+		return &line;
+	}
+
+	line_iterator& operator++() {
+		advance();
+		return *this;
+	}
+
+	line_iterator operator++(int) {
+		line_iterator old = *this;
+		advance();
+		return old;
+	}
+
+	bool operator==(const line_iterator &other) const {
+		return next == other.next;
+	}
+
+	bool operator!=(const line_iterator &other) const {
+		return next != other.next;
+	}
+};
+
+/**
+ * A lazy range of the lines of a block of text, for use in range based for loops.
+ * A final line without a trailing newline is included, like with std::getline.
+ */
+class line_range {
+private:
+	/**
+	 * The text to split into lines.
+	 */
+	std::string_view text;
+
+	/**
+	 * Whether empty lines should be skipped.
+	 */
+	bool skip_empty;
+
+public:
+	/**
+	 * Creates a new line range over the given text.
+	 *
+	 * @param text			The text to split. Has to outlive this range and its iterators.
+	 * @param skip_empty	Whether empty lines should be skipped.
+	 */
+	explicit line_range(const std::string_view text,
+			const bool skip_empty = false) :
+			text(text), skip_empty(skip_empty) {
+	}
+
+	line_iterator begin() const {
+		return line_iterator(text, skip_empty);
+	}
+
+	line_iterator end() const {
+		return line_iterator();
+	}
+};
+}
+
+#endif /* LINES_H_ */
@@ -0,0 +1,236 @@
+/*
+ * Options.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#include "Options.h"
+#include "Parse.h"
+
+/**
+ * The day specific settings of the current execution, as "key=value" strings.
+ */
+std::array<std::string_view, aoc::MAX_SETTINGS> active_settings;
+
+/**
+ * The number of valid entries in active_settings.
+ */
+size_t active_setting_count = 0;
+
+/**
+ * Finds the option with the given name in the option table.
+ *
+ * @param name	The short or long name of the option, without dashes.
+ * @return	A pointer to the option, or NULL if there is no such option.
+ */
+const aoc::option* findOption(const std::string_view name) {
+	for (const aoc::option &option : aoc::option_table) {
+		if (name == option.long_name
+				|| (name.length() == 1 && name[0] == option.short_name)) {
+			return &option;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Parses a comma separated list of numbers and inclusive ranges, like "1,3,5-7".
+ *
+ * @param value		The list to parse.
+ * @param max		The largest number allowed in the list.
+ * @param mask		The bit mask to set the bits of all numbers in the list in.
+ * @param singles	The bit mask to set the bits of numbers not in a range in.
+ * @return	True if the list was valid.
+ */
+bool parseNumberList(std::string_view value, const uint8_t max,
+		uint32_t &mask, uint32_t &singles) {
+	do {
+		std::pair<uint8_t, uint8_t> range;
+		if (aoc::parse::range(value, range)) {
+			if (range.first < 1 || range.first > range.second
+					|| range.second > max) {
+				return false;
+			}
+			for (uint8_t i = range.first; i <= range.second; i++) {
+				mask |= 1u << i;
+			}
+		} else if (aoc::parse::number(value, range.first)) {
+			if (range.first < 1 || range.first > max) {
+				return false;
+			}
+			mask |= 1u << range.first;
+			singles |= 1u << range.first;
+		} else {
+			return false;
+		}
+	} while (aoc::parse::skip(value, ","));
+
+	return value.empty();
+}
+
+/**
+ * Parses the value of the given option into the given options.
+ *
+ * @param type		The option the value belongs to.
+ * @param value		The value to parse.
+ * @param options	The options to store the parsed value in.
+ * @return	True if the value was valid.
+ */
+bool parseValue(const aoc::option_type type, const std::string_view value,
+		aoc::run_options &options) {
+	switch (type) {
+	case aoc::option_type::JOBS:
+		options.threads = aoc::parse::to_number<size_t>(value);
+		return options.threads > 0;
+	case aoc::option_type::BENCH:
+		options.bench_runs = aoc::parse::to_number<size_t>(value);
+		return options.bench_runs > 0;
+	case aoc::option_type::WARMUP: {
+		std::string_view rest = value;
+		return aoc::parse::number(rest, options.warmup_runs) && rest.empty();
+	}
+	case aoc::option_type::FORMAT:
+		if (value == "text") {
+			options.format = aoc::output_format::TEXT;
+		} else if (value == "json") {
+			options.format = aoc::output_format::JSON;
+		} else if (value == "csv") {
+			options.format = aoc::output_format::CSV;
+		} else {
+			return false;
+		}
+		return true;
+	case aoc::option_type::DAY:
+		return parseNumberList(value, 25, options.days, options.required_days);
+	case aoc::option_type::PART: {
+		uint32_t parts = 0;
+		uint32_t singles = 0;
+		if (!parseNumberList(value, 2, parts, singles)) {
+			return false;
+		}
+		options.parts = parts;
+		return true;
+	}
+	case aoc::option_type::SETTING:
+		if (value.find('=') == 0 || value.find('=') == std::string_view::npos
+				|| options.setting_count >= aoc::MAX_SETTINGS) {
+			return false;
+		}
+		options.settings[options.setting_count++] = value;
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool aoc::parseOptions(const int argc, const char *const argv[],
+		run_options &options) {
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		if (!parse::skip(arg, "--") && !parse::skip(arg, "-")) {
+			std::cerr << "Unexpected argument \"" << argv[i] << "\"."
+					<< std::endl;
+			return false;
+		}
+
+		// Values can be attached as "--day=1", or "-d 1" in a single argument.
+		std::string_view value;
+		bool has_value = false;
+		const size_t separator = arg.find_first_of("= ");
+		if (separator != std::string_view::npos) {
+			value = arg.substr(separator + 1);
+			arg = arg.substr(0, separator);
+			has_value = true;
+		}
+
+		const option *option = findOption(arg);
+		// Short options can have their value attached directly, like "-d1".
+		if (!option && !has_value && arg.length() > 1) {
+			option = findOption(arg.substr(0, 1));
+			if (option && !option->argument.empty()) {
+				value = arg.substr(1);
+				has_value = true;
+			} else {
+				option = NULL;
+			}
+		}
+
+		if (!option) {
+			std::cerr << "Unknown option \"" << argv[i] << "\"." << std::endl;
+			return false;
+		}
+
+		if (option->argument.empty()) {
+			if (has_value) {
+				std::cerr << "Option \"" << option->long_name
+						<< "\" doesn't take a value." << std::endl;
+				return false;
+			}
+
+			if (option->type == option_type::HELP) {
+				options.help = true;
+			} else if (option->type == option_type::TIME) {
+				options.time = true;
+			} else if (option->type == option_type::ALL) {
+				options.all = true;
+			} else if (option->type == option_type::PERF) {
+				options.perf = true;
+			}
+			continue;
+		}
+
+		if (!has_value) {
+			if (i + 1 >= argc) {
+				std::cerr << "Option \"" << option->long_name
+						<< "\" requires a value." << std::endl;
+				return false;
+			}
+			value = argv[++i];
+		}
+
+		if (!parseValue(option->type, value, options)) {
+			std::cerr << "Invalid value \"" << value << "\" for option \""
+					<< option->long_name << "\"." << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void aoc::printUsage(std::ostream &out, const char *file) {
+	out << "Usage: " << file << " [<OPTIONS>] --day <DAYS>" << std::endl;
+	out << "At least one -day argument has to be specified." << std::endl;
+	for (const option &option : option_table) {
+		// Align the descriptions to the third tab stop.
+		size_t length = 6 + option.long_name.length();
+		out << " -" << option.short_name << " --" << option.long_name;
+		if (!option.argument.empty()) {
+			out << " <" << option.argument << '>';
+			length += option.argument.length() + 3;
+		}
+		do {
+			out << '\t';
+			length = length / 8 * 8 + 8;
+		} while (length < 24);
+		out << option.description << std::endl;
+	}
+}
+
+void aoc::applySettings(const run_options &options) {
+	active_settings = options.settings;
+	active_setting_count = options.setting_count;
+}
+
+bool aoc::getSetting(const std::string_view key, std::string_view &value) {
+	for (size_t i = active_setting_count; i > 0; i--) {
+		const std::string_view setting = active_settings[i - 1];
+		const size_t separator = setting.find('=');
+		if (setting.substr(0, separator) == key) {
+			value = setting.substr(separator + 1);
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,211 @@
+/*
+ * Options.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#ifndef OPTIONS_H_
+#define OPTIONS_H_
+
+#include "Runner.h"
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+
+namespace aoc {
+/**
+ * The maximum number of day specific settings that can be given using --option.
+ */
+constexpr size_t MAX_SETTINGS = 32;
+
+/**
+ * The settings for a single execution of the runner, parsed from the command line arguments.
+ */
+struct run_options {
+	/**
+	 * Whether the help text should be printed, instead of running any days.
+	 */
+	bool help = false;
+
+	/**
+	 * Whether the execution time of each day should be printed.
+	 */
+	bool time = false;
+
+	/**
+	 * Whether all implemented days should be run, regardless of days.
+	 */
+	bool all = false;
+
+	/**
+	 * Whether hardware performance counters should be measured for each part.
+	 */
+	bool perf = false;
+
+	/**
+	 * The number of threads to run the days on. 0 to run them serially on the main thread.
+	 */
+	size_t threads = 0;
+
+	/**
+	 * The number of measured benchmark runs per part. 0 to not benchmark the days.
+	 */
+	size_t bench_runs = 0;
+
+	/**
+	 * The number of unmeasured runs before the benchmark runs.
+	 */
+	size_t warmup_runs = 3;
+
+	/**
+	 * The format in which to print the results.
+	 */
+	output_format format = output_format::TEXT;
+
+	/**
+	 * The days to run, as a bit mask. Bit N is set if day N should be run.
+	 */
+	uint32_t days = 0;
+
+	/**
+	 * The days that were selected individually, rather than as part of a range.
+	 * These are required to be implemented, while days in ranges are skipped if they aren't.
+	 */
+	uint32_t required_days = 0;
+
+	/**
+	 * The parts to run, as a bit mask. Bit 1 is set for part 1, and bit 2 for part 2.
+	 * Days solving both parts at once are always run, but only the selected results are printed.
+	 */
+	uint8_t parts = 0b110;
+
+	/**
+	 * The day specific settings, as "key=value" strings.
+	 * Only the first setting_count entries are valid.
+	 */
+	std::array<std::string_view, MAX_SETTINGS> settings;
+
+	/**
+	 * The number of day specific settings that were given.
+	 */
+	size_t setting_count = 0;
+};
+
+/**
+ * The options this program understands.
+ */
+enum class option_type {
+	HELP, TIME, ALL, PERF, JOBS, BENCH, WARMUP, FORMAT, DAY, PART, SETTING
+};
+
+/**
+ * The description of a single command line option.
+ */
+struct option {
+	/**
+	 * The single character name of this option, used as "-c".
+	 */
+	char short_name;
+
+	/**
+	 * The full name of this option, used as "--name".
+	 */
+	std::string_view long_name;
+
+	/**
+	 * The name of the argument of this option for the help text. Empty if it doesn't take one.
+	 */
+	std::string_view argument;
+
+	/**
+	 * The description of this option for the help text.
+	 */
+	std::string_view description;
+
+	/**
+	 * The option this is the description of.
+	 */
+	option_type type;
+};
+
+/**
+ * All the options this program understands.
+ * Used both to parse the arguments, and to print the help text.
+ */
+constexpr std::array<option, 11> option_table = { {
+		{ 'd', "day", "DAYS",
+				"The days to run. A day, a range like 1-25, or a comma separated list of those. Can be supplied more then once.",
+				option_type::DAY },
+		{ 'p', "part", "PARTS",
+				"The parts to run. 1, 2, or 1,2. Defaults to both parts.",
+				option_type::PART },
+		{ 'h', "help", "", "Prints this help text and terminates.",
+				option_type::HELP },
+		{ 't', "time", "", "Measures the execution time of each day.",
+				option_type::TIME },
+		{ 'a', "all", "", "Runs all implemented days. Overrides --day.",
+				option_type::ALL },
+		{ 'c', "perf", "",
+				"Measures hardware performance counters, like cycles and cache misses, for each part.",
+				option_type::PERF },
+		{ 'j', "jobs", "N",
+				"Runs the days, and their parts, in parallel on N threads.",
+				option_type::JOBS },
+		{ 'b', "bench", "N",
+				"Runs each part N more times and prints statistics about their execution times.",
+				option_type::BENCH },
+		{ 'w', "warmup", "N",
+				"The number of unmeasured runs before the benchmark runs. Defaults to 3.",
+				option_type::WARMUP },
+		{ 'f', "format", "FMT",
+				"The output format. One of text, json, or csv. Defaults to text.",
+				option_type::FORMAT },
+		{ 'o', "option", "KEY=VALUE",
+				"Sets a day specific setting, like exec_mode=bytecode for 2021 day 24. Can be supplied more then once.",
+				option_type::SETTING } } };
+
+/**
+ * Parses the given command line arguments into the given options.
+ * Never allocates memory.
+ *
+ * Options can be given as "-d 1", "-d1", "--day 1", "-day 1", or "--day=1".
+ * Prints an error message to std::cerr if the arguments are invalid.
+ *
+ * @param argc		The number of arguments given to the program.
+ * @param argv		The arguments given to the program, starting with the execution path.
+ * @param options	The options to store the parsed settings in.
+ * @return	True if all arguments were valid.
+ */
+bool parseOptions(const int argc, const char *const argv[],
+		run_options &options);
+
+/**
+ * Prints the help text for this program to the given output stream.
+ *
+ * @param out	The output stream to print the usage to.
+ * @param file	The current execution path of this process.
+ */
+void printUsage(std::ostream &out, const char *file);
+
+/**
+ * Makes the day specific settings of the given options available through getSetting.
+ * Called by the runner before running any days.
+ *
+ * @param options	The options containing the settings to use.
+ */
+void applySettings(const run_options &options);
+
+/**
+ * Gets the value of a day specific setting given using --option.
+ * If the same setting was given more than once, the last value is used.
+ *
+ * @param key	The name of the setting to get.
+ * @param value	The string_view to store the value of the setting in.
+ * @return	True if the setting was given.
+ */
+bool getSetting(const std::string_view key, std::string_view &value);
+}
+
+#endif /* OPTIONS_H_ */
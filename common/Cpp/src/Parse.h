@@ -0,0 +1,165 @@
+/*
+ * Parse.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#ifndef PARSE_H_
+#define PARSE_H_
+
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace aoc {
+/**
+ * Non-allocating parsing helpers for string_views.
+ *
+ * All of them consume what they parsed from the start of the given view on success,
+ * and leave it unchanged on failure.
+ * Integers are parsed using std::from_chars, so they are locale independent,
+ * and don't accept a leading '+' or whitespace.
+ */
+namespace parse {
+/**
+ * Parses the integer at the start of the given string.
+ * Negative numbers are only accepted for signed types.
+ *
+ * @tparam T		The integer type to parse.
+ * @param str		The string to parse. Consumed up to the end of the number.
+ * @param value		The variable to store the parsed number in.
+ * @return	True if a number in the range of T was parsed.
+ */
+template<typename T>
+bool number(std::string_view &str, T &value);
+
+/**
+ * Skips to the next integer in the given string, and parses it.
+ * For signed types a '-' directly in front of a digit is part of the number.
+ *
+ * @tparam T		The integer type to parse.
+ * @param str		The string to parse. Consumed up to the end of the number.
+ * @param value		The variable to store the parsed number in.
+ * @return	True if a number in the range of T was found and parsed.
+ */
+template<typename T>
+bool next_number(std::string_view &str, T &value);
+
+/**
+ * Parses the given string as a single integer.
+ *
+ * @tparam T	The integer type to parse.
+ * @param str	The string to parse. Has to contain nothing but the number.
+ * @return	The parsed number, or 0 if the string isn't a valid number.
+ */
+template<typename T>
+T to_number(const std::string_view str);
+
+/**
+ * Removes the given prefix from the start of the given string.
+ *
+ * @param str		The string to remove the prefix from.
+ * @param prefix	The prefix to remove.
+ * @return	True if the string started with the prefix.
+ */
+inline bool skip(std::string_view &str, const std::string_view prefix) {
+	if (str.substr(0, prefix.length()) != prefix) {
+		return false;
+	}
+	str.remove_prefix(prefix.length());
+	return true;
+}
+
+/**
+ * Parses two integers separated by the given separator, like "x,y".
+ *
+ * @tparam T			The integer type of the two values.
+ * @param str			The string to parse. Consumed up to the end of the second number.
+ * @param value			The pair to store the parsed numbers in.
+ * @param separator		The string between the two numbers.
+ * @return	True if both numbers and the separator were parsed.
+ */
+template<typename T>
+bool pair(std::string_view &str, std::pair<T, T> &value,
+		const std::string_view separator = ",");
+
+/**
+ * Parses an inclusive range of the form "a-b".
+ *
+ * @tparam T		The integer type of the range bounds.
+ * @param str		The string to parse. Consumed up to the end of the range.
+ * @param value		The pair to store the start and end of the range in.
+ * @return	True if the range was parsed.
+ */
+template<typename T>
+bool range(std::string_view &str, std::pair<T, T> &value) {
+	return pair(str, value, "-");
+}
+}
+}
+
+template<typename T>
+bool aoc::parse::number(std::string_view &str, T &value) {
+	static_assert(std::is_integral_v<T>, "Only integers can be parsed.");
+	T result;
+	const std::from_chars_result res = std::from_chars(str.data(),
+			str.data() + str.length(), result);
+	if (res.ec != std::errc()) {
+		return false;
+	}
+
+	value = result;
+	str.remove_prefix(res.ptr - str.data());
+	return true;
+}
+
+template<typename T>
+bool aoc::parse::next_number(std::string_view &str, T &value) {
+	size_t start = 0;
+	while (start < str.length()) {
+		const char c = str[start];
+		if (c >= '0' && c <= '9') {
+			break;
+		} else if (std::is_signed_v<T> && c == '-' && start + 1 < str.length()
+				&& str[start + 1] >= '0' && str[start + 1] <= '9') {
+			break;
+		}
+		start++;
+	}
+
+	std::string_view rest = str.substr(start);
+	if (!number(rest, value)) {
+		return false;
+	}
+	str = rest;
+	return true;
+}
+
+template<typename T>
+T aoc::parse::to_number(const std::string_view str) {
+	std::string_view rest = str;
+	T value = 0;
+	if (!number(rest, value) || !rest.empty()) {
+		return 0;
+	}
+	return value;
+}
+
+template<typename T>
+bool aoc::parse::pair(std::string_view &str, std::pair<T, T> &value,
+		const std::string_view separator) {
+	std::string_view rest = str;
+	std::pair<T, T> result;
+	if (!number(rest, result.first) || !skip(rest, separator)
+			|| !number(rest, result.second)) {
+		return false;
+	}
+
+	value = result;
+	str = rest;
+	return true;
+}
+
+#endif /* PARSE_H_ */
@@ -0,0 +1,191 @@
+/*
+ * PerfCounters.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#include "PerfCounters.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Whether the warning about unavailable counters was already printed.
+ */
+std::atomic<bool> perf_warned(false);
+
+#ifdef __linux__
+/**
+ * The perf_event_open type and config of each perf_event.
+ */
+constexpr std::array<std::pair<uint32_t, uint64_t>, aoc::PERF_EVENT_COUNT> perf_event_configs =
+		{ { { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES }, {
+				PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS }, {
+				PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS }, {
+				PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }, {
+				PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+						| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+						| (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16) }, {
+				PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+						| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+						| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) }, {
+				PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES }, {
+				PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES } } };
+#endif
+
+double aoc::perf_stats::ratio(const perf_event numerator,
+		const perf_event denominator) const {
+	if (!available[numerator] || !available[denominator]
+			|| counts[denominator] == 0) {
+		return -1;
+	}
+	return (double) counts[numerator] / counts[denominator];
+}
+
+aoc::perf_counters::perf_counters() {
+	fds.fill(-1);
+#ifdef __linux__
+	int error = 0;
+	for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = perf_event_configs[i].first;
+		attr.config = perf_event_configs[i].second;
+		attr.disabled = 1;
+		// Also count threads started by the solver.
+		attr.inherit = 1;
+		// Required for unprivileged use with the default perf_event_paranoid setting.
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+				| PERF_FORMAT_TOTAL_TIME_RUNNING;
+		fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		if (fds[i] < 0) {
+			error = errno;
+			fds[i] = -1;
+		}
+	}
+
+	if (!is_available() && !perf_warned.exchange(true)) {
+		std::cerr << "Hardware performance counters are not available: "
+				<< std::strerror(error) << '.' << std::endl;
+		std::cerr
+				<< "They may not be supported, or require a lower /proc/sys/kernel/perf_event_paranoid."
+				<< std::endl;
+	}
+#else
+	if (!perf_warned.exchange(true)) {
+		std::cerr
+				<< "Hardware performance counters are only supported on Linux."
+				<< std::endl;
+	}
+#endif
+}
+
+aoc::perf_counters::~perf_counters() {
+#ifdef __linux__
+	for (const int fd : fds) {
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+#endif
+}
+
+bool aoc::perf_counters::is_available() const {
+	for (const int fd : fds) {
+		if (fd >= 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void aoc::perf_counters::start() {
+#ifdef __linux__
+	for (const int fd : fds) {
+		if (fd >= 0) {
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#endif
+}
+
+aoc::perf_stats aoc::perf_counters::stop() {
+	perf_stats stats;
+#ifdef __linux__
+	for (const int fd : fds) {
+		if (fd >= 0) {
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+
+	for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+		// The value, the time enabled, and the time running.
+		uint64_t values[3];
+		if (fds[i] < 0 || read(fds[i], values, sizeof(values)) != sizeof(values)
+				|| values[2] == 0) {
+			continue;
+		}
+
+		// Scale the count if the counter was multiplexed with others.
+		stats.counts[i] =
+				values[2] < values[1] ?
+						(uint64_t) ((double) values[0] * values[1] / values[2]) :
+						values[0];
+		stats.available[i] = true;
+	}
+#endif
+	return stats;
+}
+
+void aoc::printPerfStats(std::ostream &out, const perf_stats &stats) {
+	const std::ios_base::fmtflags flags = out.flags();
+	const std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(2);
+
+	bool first = true;
+	if (stats.available[PERF_CYCLES]) {
+		out << stats.counts[PERF_CYCLES] << " cycles";
+		first = false;
+	}
+	if (stats.available[PERF_INSTRUCTIONS]) {
+		out << (first ? "" : ", ") << stats.counts[PERF_INSTRUCTIONS]
+				<< " instructions";
+		first = false;
+	}
+
+	const double ipc = stats.ratio(PERF_INSTRUCTIONS, PERF_CYCLES);
+	if (ipc >= 0) {
+		out << ", IPC " << ipc;
+	}
+
+	const std::array<std::pair<const char*, double>, 3> rates = { {
+			{ "branch", stats.ratio(PERF_BRANCH_MISSES, PERF_BRANCHES) }, {
+					"L1D", stats.ratio(PERF_L1D_LOAD_MISSES, PERF_L1D_LOADS) },
+			{ "LLC", stats.ratio(PERF_LLC_MISSES, PERF_LLC_REFERENCES) } } };
+	for (const std::pair<const char*, double> &rate : rates) {
+		if (rate.second >= 0) {
+			out << (first ? "" : ", ") << rate.first << " miss rate "
+					<< rate.second * 100 << '%';
+			first = false;
+		}
+	}
+
+	if (first) {
+		out << "no counters available";
+	}
+
+	out.flags(flags);
+	out.precision(precision);
+}
@@ -0,0 +1,125 @@
+/*
+ * PerfCounters.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#ifndef PERFCOUNTERS_H_
+#define PERFCOUNTERS_H_
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+
+namespace aoc {
+/**
+ * The hardware events measured by perf_counters.
+ */
+enum perf_event {
+	PERF_CYCLES,
+	PERF_INSTRUCTIONS,
+	PERF_BRANCHES,
+	PERF_BRANCH_MISSES,
+	PERF_L1D_LOADS,
+	PERF_L1D_LOAD_MISSES,
+	PERF_LLC_REFERENCES,
+	PERF_LLC_MISSES,
+	PERF_EVENT_COUNT
+};
+
+/**
+ * The names of the perf events, as used in the machine readable output formats.
+ */
+constexpr std::array<std::string_view, PERF_EVENT_COUNT> perf_event_names = {
+		"cycles", "instructions", "branches", "branch_misses", "l1d_loads",
+		"l1d_load_misses", "llc_references", "llc_misses" };
+
+/**
+ * The hardware event counts measured for a single solver run.
+ */
+struct perf_stats {
+	/**
+	 * The measured count of each event, indexed by perf_event.
+	 * Scaled up if the kernel had to multiplex the counters.
+	 */
+	std::array<uint64_t, PERF_EVENT_COUNT> counts { };
+
+	/**
+	 * Whether each event could be measured, indexed by perf_event.
+	 */
+	std::array<bool, PERF_EVENT_COUNT> available { };
+
+	/**
+	 * Calculates the ratio between two of the measured events.
+	 *
+	 * @param numerator		The event to divide.
+	 * @param denominator	The event to divide by.
+	 * @return	The ratio between the events, or -1 if either wasn't measured or the denominator is 0.
+	 */
+	double ratio(const perf_event numerator,
+			const perf_event denominator) const;
+};
+
+/**
+ * A set of Linux perf_event_open counters measuring the calling thread,
+ * and the threads it starts while the counters are running.
+ * Counters that can't be opened are skipped, so on systems without hardware counters,
+ * or without permission to use them, nothing is measured.
+ */
+class perf_counters {
+private:
+	/**
+	 * The file descriptors of the counters, indexed by perf_event. -1 if unavailable.
+	 */
+	std::array<int, PERF_EVENT_COUNT> fds;
+
+public:
+	/**
+	 * Opens the counters for the calling thread, without starting them.
+	 * Prints a warning the first time no counter could be opened.
+	 */
+	perf_counters();
+
+	/**
+	 * Closes all counters.
+	 */
+	virtual ~perf_counters();
+
+	perf_counters(const perf_counters &counters) = delete;
+
+	perf_counters& operator=(const perf_counters &counters) = delete;
+
+	/**
+	 * Checks whether at least one counter could be opened.
+	 *
+	 * @return	True if any counter is available.
+	 */
+	bool is_available() const;
+
+	/**
+	 * Resets and starts all counters.
+	 */
+	void start();
+
+	/**
+	 * Stops all counters, and reads their values.
+	 *
+	 * @return	The counts measured since start was called.
+	 */
+	perf_stats stop();
+};
+
+/**
+ * Writes a short human readable summary of the given stats to the given output stream.
+ * Includes the instructions per cycle, and the branch, L1D, and LLC miss rates,
+ * as far as they could be measured.
+ *
+ * @param out	The output stream to write the summary to.
+ * @param stats	The stats to summarize.
+ */
+void printPerfStats(std::ostream &out, const perf_stats &stats);
+}
+
+#endif /* PERFCOUNTERS_H_ */
@@ -0,0 +1,35 @@
+/*
+ * Phase.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#include "Phase.h"
+
+bool aoc::phase_timing = false;
+
+/**
+ * The phase totals of the current thread since the last call to aoc::beginPhases.
+ */
+thread_local std::vector<aoc::phase_time> phase_totals;
+
+void aoc::phase::record(const std::string_view name, const uint64_t time_ns) {
+	for (phase_time &total : phase_totals) {
+		if (total.name == name) {
+			total.time_ns += time_ns;
+			return;
+		}
+	}
+	phase_totals.push_back( { name, time_ns });
+}
+
+void aoc::beginPhases() {
+	phase_totals.clear();
+}
+
+std::vector<aoc::phase_time> aoc::endPhases() {
+	std::vector<phase_time> phases;
+	phases.swap(phase_totals);
+	return phases;
+}
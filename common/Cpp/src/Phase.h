@@ -0,0 +1,118 @@
+/*
+ * Phase.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#ifndef PHASE_H_
+#define PHASE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace aoc {
+/**
+ * The total time spent in a single phase of a solver.
+ */
+struct phase_time {
+	/**
+	 * The name of the phase.
+	 */
+	std::string_view name;
+
+	/**
+	 * The total time spent in the phase, in nanoseconds.
+	 */
+	uint64_t time_ns;
+};
+
+/**
+ * Whether phase timing is enabled. Set by the runner.
+ */
+extern bool phase_timing;
+
+/**
+ * A scoped timer measuring a phase of a solver, like parsing the input.
+ * The time between its construction and destruction is added to the total of its phase for the current thread.
+ * Nested phases are measured independently, so the time of the inner phase is included in the outer one.
+ * Only reads a flag if phase timing is disabled.
+ *
+ * Usage:
+ * {
+ * 	aoc::phase timer("parse");
+ * 	// Parse the input.
+ * }
+ */
+class phase {
+private:
+	/**
+	 * The name of the phase this timer measures.
+	 * Has to be a string literal, or otherwise outlive the run of the solver.
+	 */
+	const std::string_view name;
+
+	/**
+	 * Whether this timer is measuring, because phase timing was enabled when it was created.
+	 */
+	const bool active;
+
+	/**
+	 * The time at which this timer was created.
+	 */
+	std::chrono::steady_clock::time_point start;
+
+	/**
+	 * Adds the given time to the total of the given phase for the current thread.
+	 *
+	 * @param name		The name of the phase.
+	 * @param time_ns	The time to add, in nanoseconds.
+	 */
+	static void record(const std::string_view name, const uint64_t time_ns);
+
+public:
+	/**
+	 * Creates a new phase timer, and starts measuring if phase timing is enabled.
+	 *
+	 * @param name	The name of the phase. Has to outlive the run of the solver, like a string literal.
+	 */
+	explicit phase(const std::string_view name) :
+			name(name), active(phase_timing) {
+		if (active) {
+			start = std::chrono::steady_clock::now();
+		}
+	}
+
+	/**
+	 * Stops measuring, and adds the measured time to the total of the phase.
+	 */
+	~phase() {
+		if (active) {
+			record(name,
+					std::chrono::duration_cast<std::chrono::nanoseconds>(
+							std::chrono::steady_clock::now() - start).count());
+		}
+	}
+
+	phase(const phase &timer) = delete;
+
+	phase& operator=(const phase &timer) = delete;
+};
+
+/**
+ * Clears the phase totals of the current thread, to start measuring a new solver run.
+ */
+void beginPhases();
+
+/**
+ * Gets the phase totals measured on the current thread since the last call to beginPhases.
+ * Phases measured on other threads, for example ones started by the solver, aren't included.
+ *
+ * @return	The total time of each phase, in the order the phases were first finished.
+ */
+std::vector<phase_time> endPhases();
+}
+
+#endif /* PHASE_H_ */
@@ -0,0 +1,853 @@
+/*
+ * Runner.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#include "Runner.h"
+#include "Options.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+/**
+ * A stream buffer discarding everything written to it.
+ */
+class null_buffer: public std::streambuf {
+protected:
+	int_type overflow(int_type c) override {
+		return traits_type::not_eof(c);
+	}
+
+	std::streamsize xsputn(const char*, std::streamsize count) override {
+		return count;
+	}
+};
+
+/**
+ * A stream buffer forwarding everything written to it to the output buffer of the current thread.
+ * Installed into std::cout while running print_func solvers, to capture their output.
+ * Tasks submitted to a thread pool inherit the output buffer, so this also captures
+ * the output of the threads a solver uses.
+ * Note that the formatting state of std::cout is still shared between all threads.
+ */
+class capture_buffer: public std::streambuf {
+private:
+	/**
+	 * The buffer to write to if the output isn't redirected.
+	 */
+	std::streambuf *fallback;
+
+	/**
+	 * The mutex serializing the writes of all threads, since the targets aren't thread safe.
+	 */
+	std::mutex mutex;
+
+	/**
+	 * Gets the buffer output should currently be written to.
+	 *
+	 * @return	The current redirection target, or the fallback if there is none.
+	 */
+	std::streambuf* target() const {
+		if (aoc::thread_output()) {
+			return aoc::thread_output();
+		}
+		return fallback;
+	}
+
+protected:
+	int_type overflow(int_type c) override {
+		if (traits_type::eq_int_type(c, traits_type::eof())) {
+			return traits_type::not_eof(c);
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		return target()->sputc(traits_type::to_char_type(c));
+	}
+
+	std::streamsize xsputn(const char *s, std::streamsize count) override {
+		std::lock_guard<std::mutex> lock(mutex);
+		return target()->sputn(s, count);
+	}
+
+	int sync() override {
+		std::lock_guard<std::mutex> lock(mutex);
+		return target()->pubsync();
+	}
+
+public:
+	/**
+	 * Creates a new capture buffer.
+	 *
+	 * @param fallback	The buffer to write to while the output isn't redirected.
+	 */
+	explicit capture_buffer(std::streambuf *fallback) :
+			fallback(fallback) {
+	}
+};
+
+/**
+ * Whether hardware performance counters should be measured for each timed run.
+ */
+bool perf_enabled = false;
+
+/**
+ * Runs the given solver function warmup + runs times, and measures the execution time of the last runs executions.
+ * Each execution gets its own input stream over the cached input, so reading the file isn't measured.
+ *
+ * @tparam F		The type of the function to benchmark. A part_func, combined_func, or print_func.
+ * @param day		The day the function solves.
+ * @param func		The function to benchmark.
+ * @param warmup	The number of unmeasured executions before the measured ones.
+ * @param runs		The number of executions to measure.
+ * @return	The measured execution times, in microseconds.
+ */
+template<typename F>
+std::vector<uint64_t> benchmark(const uint8_t day, const F func,
+		const size_t warmup, const size_t runs) {
+	for (size_t i = 0; i < warmup; i++) {
+		func(aoc::getInputStream(day));
+	}
+
+	std::vector<uint64_t> times;
+	times.reserve(runs);
+	for (size_t i = 0; i < runs; i++) {
+		const std::chrono::steady_clock::time_point start =
+				std::chrono::steady_clock::now();
+		func(aoc::getInputStream(day));
+		const std::chrono::steady_clock::time_point end =
+				std::chrono::steady_clock::now();
+		times.push_back(
+				std::chrono::duration_cast<std::chrono::microseconds>(
+						end - start).count());
+	}
+
+	return times;
+}
+
+/**
+ * Runs the part 1 or part 2 function of the given day, and creates a record of its execution.
+ * Also benchmarks the function, if bench_runs is more than 0.
+ *
+ * @param solver		The solver functions of the day.
+ * @param day			The day to run.
+ * @param part			The part of the day to run. Either 1 or 2.
+ * @param bench_runs	The number of measured benchmark runs. 0 to not benchmark the part.
+ * @param warmup_runs	The number of unmeasured runs before the benchmark runs.
+ * @return	The record of the execution of the part.
+ */
+aoc::run_record runPart(const aoc::day_solver &solver, const uint8_t day,
+		const uint8_t part, const size_t bench_runs, const size_t warmup_runs) {
+	const aoc::part_func func = part == 1 ? solver.part1 : solver.part2;
+	aoc::run_record record;
+	record.day = day;
+	record.part = part;
+	record.input_bytes = aoc::getInput(day).length();
+
+	std::optional<aoc::perf_counters> counters;
+	if (perf_enabled) {
+		counters.emplace();
+		counters->start();
+	}
+	aoc::beginPhases();
+	const std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	record.result = func(aoc::getInputStream(day));
+	const std::chrono::steady_clock::time_point end =
+			std::chrono::steady_clock::now();
+	if (counters && counters->is_available()) {
+		record.perf = counters->stop();
+	}
+	record.phases = aoc::endPhases();
+	record.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			end - start).count();
+	record.peak_rss_kb = aoc::getPeakRSS();
+
+	if (bench_runs > 0) {
+		record.bench = aoc::calculateStats(
+				benchmark(day, func, warmup_runs, bench_runs));
+	}
+
+	return record;
+}
+
+/**
+ * Runs the combined function of the given day, and creates records of its execution.
+ * Both records share the execution time, memory usage, and benchmark statistics.
+ *
+ * @param solver		The solver functions of the day.
+ * @param day			The day to run.
+ * @param bench_runs	The number of measured benchmark runs. 0 to not benchmark the day.
+ * @param warmup_runs	The number of unmeasured runs before the benchmark runs.
+ * @return	The records for part 1 and part 2 of the day.
+ */
+std::vector<aoc::run_record> runCombined(const aoc::day_solver &solver,
+		const uint8_t day, const size_t bench_runs, const size_t warmup_runs) {
+	aoc::run_record record;
+	record.day = day;
+	record.combined = true;
+	record.input_bytes = aoc::getInput(day).length();
+
+	std::optional<aoc::perf_counters> counters;
+	if (perf_enabled) {
+		counters.emplace();
+		counters->start();
+	}
+	aoc::beginPhases();
+	const std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	const std::pair<std::string, std::string> res = solver.combined(
+			aoc::getInputStream(day));
+	const std::chrono::steady_clock::time_point end =
+			std::chrono::steady_clock::now();
+	if (counters && counters->is_available()) {
+		record.perf = counters->stop();
+	}
+	record.phases = aoc::endPhases();
+	record.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			end - start).count();
+	record.peak_rss_kb = aoc::getPeakRSS();
+
+	if (bench_runs > 0) {
+		record.bench = aoc::calculateStats(
+				benchmark(day, solver.combined, warmup_runs, bench_runs));
+	}
+
+	std::vector<aoc::run_record> records { record, record };
+	records[0].part = 1;
+	records[0].result = res.first;
+	records[1].part = 2;
+	records[1].result = res.second;
+	return records;
+}
+
+/**
+ * Runs the print function of the given day, and creates a record of its execution.
+ * The output of the benchmark runs is always discarded.
+ * Requires a capture_buffer to be installed into std::cout.
+ *
+ * @param solver		The solver functions of the day.
+ * @param day			The day to run.
+ * @param bench_runs	The number of measured benchmark runs. 0 to not benchmark the day.
+ * @param warmup_runs	The number of unmeasured runs before the benchmark runs.
+ * @param capture		Whether to store the output of the day in the record, instead of printing it.
+ * @return	The record of the execution of the day.
+ */
+aoc::run_record runPrint(const aoc::day_solver &solver, const uint8_t day,
+		const size_t bench_runs, const size_t warmup_runs, const bool capture) {
+	std::streambuf *&output = aoc::thread_output();
+	aoc::run_record record;
+	record.day = day;
+	record.combined = true;
+	record.input_bytes = aoc::getInput(day).length();
+
+	std::ostringstream captured;
+	if (capture) {
+		output = captured.rdbuf();
+	}
+	std::optional<aoc::perf_counters> counters;
+	if (perf_enabled) {
+		counters.emplace();
+		counters->start();
+	}
+	aoc::beginPhases();
+	const std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	solver.print(aoc::getInputStream(day));
+	const std::chrono::steady_clock::time_point end =
+			std::chrono::steady_clock::now();
+	if (counters && counters->is_available()) {
+		record.perf = counters->stop();
+	}
+	record.phases = aoc::endPhases();
+	std::cout.flush();
+	output = NULL;
+	record.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			end - start).count();
+	record.peak_rss_kb = aoc::getPeakRSS();
+
+	record.result = captured.str();
+	while (record.result.length() > 0 && record.result.back() == '\n') {
+		record.result.pop_back();
+	}
+
+	if (bench_runs > 0) {
+		null_buffer discard;
+		output = &discard;
+		record.bench = aoc::calculateStats(
+				benchmark(day, solver.print, warmup_runs, bench_runs));
+		std::cout.flush();
+		output = NULL;
+	}
+
+	return record;
+}
+
+/**
+ * Runs all selected functions of the given day, and creates records of their executions.
+ *
+ * @param solver		The solver functions of the day.
+ * @param day			The day to run.
+ * @param parts			The parts to run, as a bit mask. Bit 1 for part 1, and bit 2 for part 2.
+ * @param bench_runs	The number of measured benchmark runs. 0 to not benchmark the day.
+ * @param warmup_runs	The number of unmeasured runs before the benchmark runs.
+ * @param capture		Whether to capture the output of days printing their own results.
+ * @return	The records of all parts of the day, in order.
+ */
+std::vector<aoc::run_record> runDay(const aoc::day_solver &solver,
+		const uint8_t day, const uint8_t parts, const size_t bench_runs,
+		const size_t warmup_runs, const bool capture) {
+	if (solver.print) {
+		return {runPrint(solver, day, bench_runs, warmup_runs, capture)};
+	} else if (solver.combined) {
+		return runCombined(solver, day, bench_runs, warmup_runs);
+	}
+
+	std::vector<aoc::run_record> records;
+	if (solver.part1 && (parts & 0b10)) {
+		records.push_back(runPart(solver, day, 1, bench_runs, warmup_runs));
+	}
+	if (solver.part2 && (parts & 0b100)) {
+		records.push_back(runPart(solver, day, 2, bench_runs, warmup_runs));
+	}
+	return records;
+}
+
+/**
+ * Removes the records of the parts that weren't selected.
+ * Records of days printing their own results are always kept.
+ *
+ * @param records	The records to filter.
+ * @param parts		The selected parts, as a bit mask. Bit 1 for part 1, and bit 2 for part 2.
+ */
+void filterParts(std::vector<aoc::run_record> &records, const uint8_t parts) {
+	records.erase(
+			std::remove_if(records.begin(), records.end(),
+					[parts](const aoc::run_record &record) {
+						return record.part != 0 && !(parts & (1 << record.part));
+					}), records.end());
+}
+
+/**
+ * Prints the results of a single day in the given output format.
+ *
+ * @param records	The records of all parts of the day, in order.
+ * @param time		Whether to print the execution time of the day.
+ * @param format	The format in which to print the results.
+ */
+void printDay(const std::vector<aoc::run_record> &records, const bool time,
+		const aoc::output_format format) {
+	if (format != aoc::output_format::TEXT) {
+		for (const aoc::run_record &record : records) {
+			aoc::printRecord(std::cout, format, record);
+		}
+		return;
+	}
+
+	const uint16_t day = records.front().day;
+	const bool combined = records.front().combined;
+	for (const aoc::run_record &record : records) {
+		if (record.part == 0) {
+			if (record.result.length() > 0) {
+				std::cout << record.result << std::endl;
+			}
+		} else {
+			std::cout << "Day " << day << " part " << (uint16_t) record.part
+					<< " result: " << record.result << std::endl;
+		}
+	}
+
+	if (time) {
+		std::cout << "Running day " << day;
+		if (combined) {
+			std::cout << " took ";
+			aoc::formatTime(std::cout, records.front().time_ns / 1000);
+		} else {
+			for (size_t i = 0; i < records.size(); i++) {
+				if (i > 0) {
+					std::cout << ", and";
+				}
+				std::cout << " part " << (uint16_t) records[i].part << " took ";
+				aoc::formatTime(std::cout, records[i].time_ns / 1000);
+			}
+		}
+		std::cout << '.' << std::endl;
+
+		for (const aoc::run_record &record : records) {
+			if (!record.phases.empty()) {
+				std::cout << "Day " << day;
+				if (!combined) {
+					std::cout << " part " << (uint16_t) record.part;
+				}
+				std::cout << " phases: ";
+				aoc::printPhases(std::cout, record.phases);
+				std::cout << '.' << std::endl;
+			}
+
+			if (combined) {
+				break;
+			}
+		}
+	}
+
+	for (const aoc::run_record &record : records) {
+		if (record.perf.has_value()) {
+			std::cout << "Day " << day;
+			if (!combined) {
+				std::cout << " part " << (uint16_t) record.part;
+			}
+			std::cout << " counters: ";
+			aoc::printPerfStats(std::cout, record.perf.value());
+			std::cout << '.' << std::endl;
+		}
+
+		if (record.bench.has_value()) {
+			std::cout << "Day " << day;
+			if (!combined) {
+				std::cout << " part " << (uint16_t) record.part;
+			}
+			std::cout << ' ';
+			aoc::printStats(std::cout, record.bench.value());
+			std::cout << '.' << std::endl;
+		}
+
+		if (combined) {
+			break;
+		}
+	}
+}
+
+int aoc::runMain(int argc, char *argv[], const day_table &solvers) {
+	if (argc == 0) {
+		std::cerr
+				<< "This program expects the first parameter to be its execution path,"
+				<< std::endl;
+		std::cerr << "however it wasn't given a parameter." << std::endl;
+		return 1;
+	}
+
+	run_options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage(std::cout, argv[0]);
+		return 1;
+	} else if (options.help) {
+		printUsage(std::cout, argv[0]);
+		return 0;
+	}
+
+	std::vector<uint8_t> days;
+	for (uint8_t day = 1; day <= 25; day++) {
+		if (!options.all && !(options.days & (1u << day))) {
+			continue;
+		}
+
+		const day_solver &solver = solvers[day];
+		if (solver.print || solver.combined
+				|| (solver.part1 && (options.parts & 0b10))
+				|| (solver.part2 && (options.parts & 0b100))) {
+			days.push_back(day);
+		} else if (!options.all && !solver.is_implemented()
+				&& (options.required_days & (1u << day))) {
+			std::cerr << "Can't run day " << (uint16_t) day
+					<< " because it isn't implemented yet." << std::endl;
+			std::exit(5);
+		}
+	}
+
+	if (days.empty()) {
+		printUsage(std::cout, argv[0]);
+		return 1;
+	}
+
+	const bool time = options.time;
+	const size_t threads = options.threads;
+	const size_t bench_runs = options.bench_runs;
+	const size_t warmup_runs = options.warmup_runs;
+	const uint8_t parts = options.parts;
+	const output_format format = options.format;
+	phase_timing = time;
+	perf_enabled = options.perf;
+	applySettings(options);
+
+	// Machine readable output should only contain the records.
+	const bool text = format == output_format::TEXT;
+	if (time && text) {
+		std::cout << "Timing day executions." << std::endl;
+	}
+
+	if (bench_runs > 0 && text) {
+		std::cout << "Benchmarking day executions with " << warmup_runs
+				<< " warmup and " << bench_runs << " measured runs per part."
+				<< std::endl;
+	}
+
+	if (!text) {
+		printRecordHeader(std::cout, format);
+	}
+
+	// Days printing their own results need their output redirected.
+	std::streambuf *const cout_buf = std::cout.rdbuf();
+	capture_buffer capture(cout_buf);
+	for (const uint8_t day : days) {
+		if (solvers[day].print) {
+			std::cout.rdbuf(&capture);
+			break;
+		}
+	}
+
+	if (threads == 0) {
+		for (const uint8_t day : days) {
+			if (text) {
+				std::cout << "Running day " << (uint16_t) day << '.'
+						<< std::endl;
+			}
+
+			std::vector<run_record> records = runDay(solvers[day], day, parts,
+					bench_runs, warmup_runs, !text);
+			filterParts(records, parts);
+			printDay(records, time, format);
+		}
+		std::cout.rdbuf(cout_buf);
+		return 0;
+	}
+
+	if (text) {
+		std::cout << "Running " << days.size() << " days on " << threads
+				<< " threads." << std::endl;
+	}
+
+	const std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	std::vector<std::vector<std::future<std::vector<run_record>>>> futures;
+	thread_pool pool(threads);
+	for (const uint8_t day : days) {
+		const day_solver &solver = solvers[day];
+		std::vector<std::future<std::vector<run_record>>> day_futures;
+		if (solver.print) {
+			day_futures.push_back(
+					pool.submit([&solver, day, bench_runs, warmup_runs]() {
+						return std::vector<run_record> { runPrint(solver, day,
+								bench_runs, warmup_runs, true) };
+					}));
+		} else if (solver.combined) {
+			day_futures.push_back(
+					pool.submit([&solver, day, bench_runs, warmup_runs]() {
+						return runCombined(solver, day, bench_runs,
+								warmup_runs);
+					}));
+		} else {
+			for (uint8_t part = 1; part <= 2; part++) {
+				if ((part == 1 ? solver.part1 : solver.part2)
+						&& (parts & (1 << part))) {
+					day_futures.push_back(
+							pool.submit(
+									[&solver, day, part, bench_runs,
+											warmup_runs]() {
+										return std::vector<run_record> {
+												runPart(solver, day, part,
+														bench_runs,
+														warmup_runs) };
+									}));
+				}
+			}
+		}
+		futures.push_back(std::move(day_futures));
+	}
+
+	// Print the results in day order, as soon as they are available.
+	uint64_t total_ns = 0;
+	const run_record *critical = NULL;
+	std::vector<std::vector<run_record>> results;
+	results.reserve(days.size());
+	for (std::vector<std::future<std::vector<run_record>>> &day_futures : futures) {
+		std::vector<run_record> records;
+		for (std::future<std::vector<run_record>> &future : day_futures) {
+			const std::vector<run_record> part_records = future.get();
+			records.insert(records.end(), part_records.begin(),
+					part_records.end());
+		}
+		filterParts(records, parts);
+
+		if (text) {
+			std::cout << "Running day " << (uint16_t) records.front().day
+					<< '.' << std::endl;
+		}
+		printDay(records, time, format);
+		results.push_back(std::move(records));
+	}
+	const std::chrono::steady_clock::time_point end =
+			std::chrono::steady_clock::now();
+
+	// Tasks are independent, so the critical path is the longest single task.
+	for (const std::vector<run_record> &records : results) {
+		for (const run_record &record : records) {
+			if (record.part <= 1 || !record.combined) {
+				total_ns += record.time_ns;
+			}
+			if (!critical || record.time_ns > critical->time_ns) {
+				critical = &record;
+			}
+		}
+	}
+
+	if (text) {
+		std::cout << "Running " << days.size() << " days took ";
+		formatTime(std::cout,
+				std::chrono::duration_cast<std::chrono::microseconds>(
+						end - start).count());
+		std::cout << " of wall time, and ";
+		formatTime(std::cout, total_ns / 1000);
+		std::cout << " of total solver time." << std::endl;
+		std::cout << "The critical path is day " << (uint16_t) critical->day;
+		if (!critical->combined) {
+			std::cout << " part " << (uint16_t) critical->part;
+		}
+		std::cout << ", taking ";
+		formatTime(std::cout, critical->time_ns / 1000);
+		std::cout << '.' << std::endl;
+	}
+	std::cout.rdbuf(cout_buf);
+	return 0;
+}
+
+void aoc::formatTime(std::ostream &out, const uint64_t time_us) {
+	if (time_us / 3600000000 > 0) {
+		out << time_us / 60000000 << "h ";
+	}
+
+	if (time_us % 3600000000 / 60000000 > 0) {
+		out << time_us / 60000000 << "m ";
+	}
+
+	if (time_us % 60000000 / 1000000 > 0) {
+		out << time_us % 60000000 / 1000000 << "s ";
+	}
+
+	if (time_us % 1000000 / 1000 > 0) {
+		out << time_us % 1000000 / 1000 << "ms ";
+	}
+
+	out << time_us % 1000 << "µs";
+}
+
+aoc::bench_stats aoc::calculateStats(std::vector<uint64_t> times_us) {
+	std::sort(times_us.begin(), times_us.end());
+	const size_t runs = times_us.size();
+
+	bench_stats stats;
+	stats.runs = runs;
+	stats.min = times_us.front();
+	stats.max = times_us.back();
+	if (runs % 2 == 0) {
+		stats.median = (times_us[runs / 2 - 1] + times_us[runs / 2]) / 2;
+	} else {
+		stats.median = times_us[runs / 2];
+	}
+	// Nearest-rank method, ceil(0.95 * runs) - 1 without floating point errors.
+	stats.p95 = times_us[(runs * 95 + 99) / 100 - 1];
+
+	double sum = 0;
+	for (const uint64_t time_us : times_us) {
+		sum += time_us;
+	}
+	stats.mean = sum / runs;
+
+	double squares = 0;
+	for (const uint64_t time_us : times_us) {
+		squares += (time_us - stats.mean) * (time_us - stats.mean);
+	}
+	stats.stddev = runs > 1 ? std::sqrt(squares / (runs - 1)) : 0;
+
+	return stats;
+}
+
+void aoc::printPhases(std::ostream &out,
+		const std::vector<phase_time> &phases) {
+	for (size_t i = 0; i < phases.size(); i++) {
+		if (i > 0) {
+			out << ", ";
+		}
+		out << phases[i].name << ' ';
+		formatTime(out, phases[i].time_ns / 1000);
+	}
+}
+
+void aoc::printStats(std::ostream &out, const bench_stats &stats) {
+	out << "over " << stats.runs << " runs: min ";
+	formatTime(out, stats.min);
+	out << ", median ";
+	formatTime(out, stats.median);
+	out << ", p95 ";
+	formatTime(out, stats.p95);
+	out << ", max ";
+	formatTime(out, stats.max);
+	out << ", standard deviation ";
+	formatTime(out, std::llround(stats.stddev));
+}
+
+size_t aoc::getPeakRSS() {
+#if defined(__unix__) || defined(__APPLE__)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+#ifdef __APPLE__
+	// MacOS reports the max RSS in bytes, rather than kilobytes.
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Writes the given string to the given output stream as a quoted and escaped JSON string.
+ *
+ * @param out	The output stream to write the string to.
+ * @param str	The string to write.
+ */
+void writeJsonString(std::ostream &out, const std::string &str) {
+	out << '"';
+	for (const char c : str) {
+		switch (c) {
+		case '"':
+			out << "\\\"";
+			break;
+		case '\\':
+			out << "\\\\";
+			break;
+		case '\n':
+			out << "\\n";
+			break;
+		case '\r':
+			out << "\\r";
+			break;
+		case '\t':
+			out << "\\t";
+			break;
+		default:
+			if ((unsigned char) c < 0x20) {
+				out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+						<< (uint16_t) c << std::dec << std::setfill(' ');
+			} else {
+				out << c;
+			}
+		}
+	}
+	out << '"';
+}
+
+/**
+ * Writes the given string to the given output stream as a quoted CSV field.
+ *
+ * @param out	The output stream to write the field to.
+ * @param str	The string to write.
+ */
+void writeCsvString(std::ostream &out, const std::string &str) {
+	out << '"';
+	for (const char c : str) {
+		if (c == '"') {
+			out << '"';
+		}
+		out << c;
+	}
+	out << '"';
+}
+
+void aoc::printRecordHeader(std::ostream &out, const output_format format) {
+	if (format == output_format::CSV) {
+		out << "day,part,combined,result,time_ns,peak_rss_kb,input_bytes,"
+				<< "bench_runs,bench_min_us,bench_median_us,bench_p95_us,"
+				<< "bench_max_us,bench_stddev_us,phases";
+		for (const std::string_view name : perf_event_names) {
+			out << ",perf_" << name;
+		}
+		out << std::endl;
+	}
+}
+
+void aoc::printRecord(std::ostream &out, const output_format format,
+		const run_record &record) {
+	if (format == output_format::JSON) {
+		out << "{\"day\":" << (uint16_t) record.day;
+		out << ",\"part\":" << (uint16_t) record.part;
+		out << ",\"combined\":" << (record.combined ? "true" : "false");
+		out << ",\"result\":";
+		writeJsonString(out, record.result);
+		out << ",\"time_ns\":" << record.time_ns;
+		out << ",\"peak_rss_kb\":" << record.peak_rss_kb;
+		out << ",\"input_bytes\":" << record.input_bytes;
+		if (record.bench.has_value()) {
+			const bench_stats &stats = record.bench.value();
+			out << ",\"bench\":{\"runs\":" << stats.runs;
+			out << ",\"min_us\":" << stats.min;
+			out << ",\"median_us\":" << stats.median;
+			out << ",\"p95_us\":" << stats.p95;
+			out << ",\"max_us\":" << stats.max;
+			out << ",\"stddev_us\":" << stats.stddev << '}';
+		}
+		if (!record.phases.empty()) {
+			out << ",\"phases\":{";
+			for (size_t i = 0; i < record.phases.size(); i++) {
+				if (i > 0) {
+					out << ',';
+				}
+				writeJsonString(out, std::string(record.phases[i].name));
+				out << ':' << record.phases[i].time_ns;
+			}
+			out << '}';
+		}
+		if (record.perf.has_value()) {
+			const perf_stats &stats = record.perf.value();
+			out << ",\"perf\":{";
+			bool first = true;
+			for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+				if (stats.available[i]) {
+					out << (first ? "\"" : ",\"") << perf_event_names[i]
+							<< "\":" << stats.counts[i];
+					first = false;
+				}
+			}
+			out << '}';
+		}
+		out << '}' << std::endl;
+	} else if (format == output_format::CSV) {
+		out << (uint16_t) record.day << ',' << (uint16_t) record.part << ','
+				<< (record.combined ? "true" : "false") << ',';
+		writeCsvString(out, record.result);
+		out << ',' << record.time_ns << ',' << record.peak_rss_kb << ','
+				<< record.input_bytes << ',';
+		if (record.bench.has_value()) {
+			const bench_stats &stats = record.bench.value();
+			out << stats.runs << ',' << stats.min << ',' << stats.median << ','
+					<< stats.p95 << ',' << stats.max << ',' << stats.stddev;
+		} else {
+			out << ",,,,,";
+		}
+		out << ',';
+		// Phase names are identifiers, so they don't need quoting.
+		for (size_t i = 0; i < record.phases.size(); i++) {
+			if (i > 0) {
+				out << ';';
+			}
+			out << record.phases[i].name << '=' << record.phases[i].time_ns;
+		}
+		for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+			out << ',';
+			if (record.perf.has_value() && record.perf->available[i]) {
+				out << record.perf->counts[i];
+			}
+		}
+		out << std::endl;
+	}
+}
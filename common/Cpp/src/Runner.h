@@ -0,0 +1,307 @@
+/*
+ * Runner.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#ifndef RUNNER_H_
+#define RUNNER_H_
+
+#include "Input.h"
+#include "PerfCounters.h"
+#include "Phase.h"
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aoc {
+/**
+ * Formats the given time in microseconds to the given output stream.
+ *
+ * @param out		The output stream to print the time to.
+ * @param time_us	The time to print to the stream.
+ */
+void formatTime(std::ostream &out, const uint64_t time_us);
+
+/**
+ * The statistics calculated from the measured execution times of a benchmarked part.
+ * All times are in microseconds.
+ */
+struct bench_stats {
+	/**
+	 * The number of measured runs these statistics were calculated from.
+	 */
+	size_t runs;
+
+	/**
+	 * The shortest measured execution time.
+	 */
+	uint64_t min;
+
+	/**
+	 * The median of the measured execution times.
+	 */
+	uint64_t median;
+
+	/**
+	 * The 95th percentile of the measured execution times, using the nearest-rank method.
+	 */
+	uint64_t p95;
+
+	/**
+	 * The longest measured execution time.
+	 */
+	uint64_t max;
+
+	/**
+	 * The arithmetic mean of the measured execution times.
+	 */
+	double mean;
+
+	/**
+	 * The sample standard deviation of the measured execution times.
+	 */
+	double stddev;
+};
+
+/**
+ * Calculates the benchmark statistics for the given execution times.
+ *
+ * @param times_us	The measured execution times, in microseconds. Must not be empty.
+ * @return	The statistics describing the given execution times.
+ */
+bench_stats calculateStats(std::vector<uint64_t> times_us);
+
+/**
+ * Writes the given phase times to the given output stream, as a comma separated list.
+ * Uses formatTime to format the individual times.
+ *
+ * @param out		The output stream to print the phase times to.
+ * @param phases	The phase times to print.
+ */
+void printPhases(std::ostream &out, const std::vector<phase_time> &phases);
+
+/**
+ * Writes the given benchmark statistics to the given output stream.
+ * Uses formatTime to format the individual times.
+ *
+ * @param out	The output stream to print the statistics to.
+ * @param stats	The statistics to print.
+ */
+void printStats(std::ostream &out, const bench_stats &stats);
+
+/**
+ * The formats in which the results of the executed days can be printed.
+ */
+enum class output_format {
+	/**
+	 * Human readable text, mixed with the output of the days.
+	 */
+	TEXT,
+	/**
+	 * One JSON object per line for each executed part.
+	 */
+	JSON,
+	/**
+	 * A CSV table with a header line and one row for each executed part.
+	 */
+	CSV
+};
+
+/**
+ * The machine readable record of the execution of a single part of a day.
+ */
+struct run_record {
+	/**
+	 * The day that was executed.
+	 */
+	uint8_t day = 0;
+
+	/**
+	 * The part of the day that was executed.
+	 * 0 for days printing their own results, since they always solve both parts.
+	 */
+	uint8_t part = 0;
+
+	/**
+	 * Whether the part was solved by a combined or printing function.
+	 * If true, both parts share the same time and memory usage.
+	 */
+	bool combined = false;
+
+	/**
+	 * The result returned by the solver.
+	 * For days printing their own results, the captured output, if it was captured.
+	 */
+	std::string result;
+
+	/**
+	 * The wall time it took to solve this part, in nanoseconds.
+	 */
+	uint64_t time_ns = 0;
+
+	/**
+	 * The peak resident set size of this process after solving this part, in kilobytes.
+	 * 0 if it can't be determined on this platform.
+	 */
+	size_t peak_rss_kb = 0;
+
+	/**
+	 * The size of the input file of the day, in bytes.
+	 */
+	uintmax_t input_bytes = 0;
+
+	/**
+	 * The benchmark statistics of this part, if it was benchmarked.
+	 */
+	std::optional<bench_stats> bench;
+
+	/**
+	 * The time spent in each phase the solver measured using aoc::phase.
+	 * Empty if phase timing was disabled, or the solver doesn't measure phases.
+	 */
+	std::vector<phase_time> phases;
+
+	/**
+	 * The hardware performance counters measured during the timed run, if they were enabled.
+	 */
+	std::optional<perf_stats> perf;
+};
+
+/**
+ * Gets the peak resident set size of this process so far.
+ *
+ * @return	The peak RSS in kilobytes, or 0 if it can't be determined on this platform.
+ */
+size_t getPeakRSS();
+
+/**
+ * Writes the header for the records in the given format to the given output stream, if it has one.
+ *
+ * @param out		The output stream to write the header to.
+ * @param format	The format of the records that will be printed.
+ */
+void printRecordHeader(std::ostream &out, const output_format format);
+
+/**
+ * Writes the given record to the given output stream in the given format.
+ * Does nothing for output_format::TEXT.
+ *
+ * @param out		The output stream to write the record to.
+ * @param format	The format to write the record in.
+ * @param record	The record to write.
+ */
+void printRecord(std::ostream &out, const output_format format,
+		const run_record &record);
+
+/**
+ * A pointer to a function that solves a single part of a single day.
+ */
+typedef std::string (*part_func)(input_stream input);
+
+/**
+ * A pointer to a function that solves both parts of a day at once.
+ */
+typedef std::pair<std::string, std::string> (*combined_func)(
+		input_stream input);
+
+/**
+ * A pointer to a function that solves both parts of a day,
+ * and prints the results to std::cout itself.
+ */
+typedef void (*print_func)(input_stream input);
+
+/**
+ * The solver functions of a single day.
+ * Only one kind of solver is set for each day.
+ * Consists of nothing but function pointers, so tables of these can be constant expressions.
+ */
+struct day_solver {
+	/**
+	 * The function solving part 1 of the day, or NULL.
+	 */
+	part_func part1;
+
+	/**
+	 * The function solving part 2 of the day, or NULL.
+	 */
+	part_func part2;
+
+	/**
+	 * The function solving both parts of the day, or NULL.
+	 */
+	combined_func combined;
+
+	/**
+	 * The function solving and printing both parts of the day, or NULL.
+	 */
+	print_func print;
+
+	/**
+	 * Creates a new day_solver for a day that isn't implemented.
+	 */
+	constexpr day_solver() :
+			part1(NULL), part2(NULL), combined(NULL), print(NULL) {
+	}
+
+	/**
+	 * Creates a new day_solver for a day with separate functions for each part.
+	 *
+	 * @param part1	The function solving part 1, or NULL.
+	 * @param part2	The function solving part 2, or NULL.
+	 */
+	constexpr day_solver(const part_func part1, const part_func part2) :
+			part1(part1), part2(part2), combined(NULL), print(NULL) {
+	}
+
+	/**
+	 * Creates a new day_solver for a day solving both parts at once.
+	 *
+	 * @param combined	The function solving both parts.
+	 */
+	constexpr explicit day_solver(const combined_func combined) :
+			part1(NULL), part2(NULL), combined(combined), print(NULL) {
+	}
+
+	/**
+	 * Creates a new day_solver for a day printing its own results.
+	 *
+	 * @param print	The function solving and printing both parts.
+	 */
+	constexpr explicit day_solver(const print_func print) :
+			part1(NULL), part2(NULL), combined(NULL), print(print) {
+	}
+
+	/**
+	 * Checks whether any solver function is set for this day.
+	 *
+	 * @return	True if this day can be run.
+	 */
+	constexpr bool is_implemented() const {
+		return part1 || part2 || combined || print;
+	}
+};
+
+/**
+ * The solvers of all the days of a year, indexed by their day.
+ * Index 0 is unused.
+ */
+typedef std::array<day_solver, 26> day_table;
+
+/**
+ * Parses the given command line arguments, and runs the selected days from the given table.
+ *
+ * @param argc	The number of arguments given to the program.
+ * @param argv	The arguments given to the program.
+ * @param days	The solvers of the days of the current year.
+ * @return	The program exit code.
+ */
+int runMain(int argc, char *argv[], const day_table &days);
+}
+
+#endif /* RUNNER_H_ */
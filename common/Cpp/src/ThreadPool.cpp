@@ -0,0 +1,148 @@
+/*
+ * ThreadPool.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+/**
+ * The pool the current thread is a worker of, or NULL if it isn't a worker thread.
+ */
+thread_local aoc::thread_pool *current_pool = NULL;
+
+/**
+ * The index of the current worker thread within its pool.
+ */
+thread_local size_t current_index = 0;
+
+/**
+ * The buffer the output of the current thread is redirected to, or NULL if it isn't redirected.
+ */
+thread_local std::streambuf *current_output = NULL;
+
+aoc::thread_pool::thread_pool(const size_t threads) :
+		pending(0), next_queue(0), stopping(false) {
+	size_t num_threads = threads;
+	if (num_threads == 0) {
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	queues.reserve(num_threads);
+	for (size_t i = 0; i < num_threads; i++) {
+		queues.push_back(std::make_unique<worker_queue>());
+	}
+
+	workers.reserve(num_threads);
+	for (size_t i = 0; i < num_threads; i++) {
+		workers.push_back(std::thread(&thread_pool::worker_loop, this, i));
+	}
+}
+
+aoc::thread_pool::~thread_pool() {
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+}
+
+void aoc::thread_pool::worker_loop(const size_t index) {
+	current_pool = this;
+	current_index = index;
+
+	while (true) {
+		if (run_pending_task()) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wake_mutex);
+		wake.wait(lock, [this]() {
+			return stopping || pending > 0;
+		});
+		if (stopping && pending == 0) {
+			return;
+		}
+	}
+}
+
+void aoc::thread_pool::push(std::function<void()> task) {
+	// Run the task with the output buffer of the thread submitting it.
+	task = [task = std::move(task), output = current_output]() {
+		std::streambuf *const previous = current_output;
+		current_output = output;
+		task();
+		current_output = previous;
+	};
+
+	size_t queue = get_worker_index();
+	if (queue == queues.size()) {
+		queue = next_queue++ % queues.size();
+	}
+
+	{
+		// Incrementing while holding the lock prevents lost wakeups.
+		// Incrementing before publishing the task prevents a worker taking it from decrementing first.
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		pending++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+		queues[queue]->tasks.push_back(std::move(task));
+	}
+	wake.notify_one();
+}
+
+bool aoc::thread_pool::run_pending_task() {
+	const size_t own = get_worker_index();
+	std::function<void()> task;
+	if (own < queues.size()) {
+		std::lock_guard<std::mutex> lock(queues[own]->mutex);
+		if (!queues[own]->tasks.empty()) {
+			task = std::move(queues[own]->tasks.back());
+			queues[own]->tasks.pop_back();
+		}
+	}
+
+	// Steal the oldest task from another queue, starting with the next one.
+	const size_t start = own < queues.size() ? own + 1 : 0;
+	for (size_t i = 0; !task && i < queues.size(); i++) {
+		worker_queue &queue = *queues[(start + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+	}
+
+	if (!task) {
+		return false;
+	}
+
+	pending--;
+	task();
+	return true;
+}
+
+size_t aoc::thread_pool::get_thread_count() const {
+	return workers.size();
+}
+
+size_t aoc::thread_pool::get_worker_index() const {
+	return current_pool == this ? current_index : queues.size();
+}
+
+aoc::thread_pool* aoc::thread_pool::get_current() {
+	return current_pool;
+}
+
+std::streambuf*& aoc::thread_output() {
+	return current_output;
+}
@@ -0,0 +1,183 @@
+/*
+ * ThreadPool.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: ToMe25
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace aoc {
+/**
+ * A simple work-stealing thread pool.
+ *
+ * Every worker thread has its own task queue.
+ * Workers take new tasks from the back of their own queue,
+ * and steal tasks from the front of the other queues when theirs is empty.
+ * Tasks submitted from a worker thread are added to the queue of that worker,
+ * other tasks are distributed round robin.
+ */
+class thread_pool {
+private:
+	/**
+	 * The task queue of a single worker thread.
+	 */
+	struct worker_queue {
+		/**
+		 * The mutex protecting the tasks of this queue.
+		 */
+		std::mutex mutex;
+
+		/**
+		 * The tasks waiting to be executed.
+		 */
+		std::deque<std::function<void()>> tasks;
+	};
+
+	/**
+	 * The task queues of the worker threads.
+	 * Has the same size as workers.
+	 */
+	std::vector<std::unique_ptr<worker_queue>> queues;
+
+	/**
+	 * The worker threads of this pool.
+	 */
+	std::vector<std::thread> workers;
+
+	/**
+	 * The mutex used to wait for new tasks.
+	 */
+	std::mutex wake_mutex;
+
+	/**
+	 * The condition variable notified when a new task is submitted, or the pool is stopped.
+	 */
+	std::condition_variable wake;
+
+	/**
+	 * The number of submitted tasks that were not yet taken by a worker.
+	 * Incremented while holding wake_mutex, before the task is added to a queue.
+	 */
+	std::atomic<size_t> pending;
+
+	/**
+	 * The index of the queue to add the next task submitted from outside the pool to.
+	 */
+	std::atomic<size_t> next_queue;
+
+	/**
+	 * Whether the destructor was called, and the workers should exit once all tasks are done.
+	 */
+	bool stopping;
+
+	/**
+	 * The main loop of a single worker thread.
+	 *
+	 * @param index	The index of the worker thread, and its queue.
+	 */
+	void worker_loop(const size_t index);
+
+	/**
+	 * Adds the given task to a queue and wakes up a worker.
+	 *
+	 * @param task	The task to add.
+	 */
+	void push(std::function<void()> task);
+
+public:
+	/**
+	 * Creates a new thread pool and starts its worker threads.
+	 *
+	 * @param threads	The number of worker threads to start.
+	 * 					If 0, std::thread::hardware_concurrency() threads are started.
+	 */
+	explicit thread_pool(const size_t threads = 0);
+
+	/**
+	 * Waits for all submitted tasks to finish and stops the worker threads.
+	 */
+	virtual ~thread_pool();
+
+	thread_pool(const thread_pool &pool) = delete;
+
+	thread_pool& operator=(const thread_pool &pool) = delete;
+
+	/**
+	 * Submits the given function to be executed by a worker thread.
+	 *
+	 * @tparam F	The type of the function to execute.
+	 * @param func	The function to execute.
+	 * @return	A future for the result of the function.
+	 */
+	template<typename F>
+	std::future<std::invoke_result_t<F>> submit(F &&func);
+
+	/**
+	 * Tries to take a single task and execute it on the current thread.
+	 * Meant to be used by tasks waiting for other tasks, to prevent deadlocks.
+	 *
+	 * @return	True if a task was executed.
+	 */
+	bool run_pending_task();
+
+	/**
+	 * Gets the number of worker threads of this pool.
+	 *
+	 * @return	The number of worker threads.
+	 */
+	size_t get_thread_count() const;
+
+	/**
+	 * Gets the index of the worker thread of this pool the calling thread is.
+	 *
+	 * @return	The index of the current worker thread, or get_thread_count() if it isn't one.
+	 */
+	size_t get_worker_index() const;
+
+	/**
+	 * Gets the pool the calling thread is a worker thread of.
+	 * Lets tasks submit their own tasks to the pool they run on, rather than starting a new one.
+	 *
+	 * @return	The pool of the current thread, or NULL if it isn't a worker thread.
+	 */
+	static thread_pool* get_current();
+};
+
+/**
+ * Gets the stream buffer the output of the current thread is redirected to.
+ * Tasks submitted to a thread_pool run with the output buffer of the thread that submitted them,
+ * so redirecting the output of a thread also redirects the output of the tasks it starts.
+ *
+ * @return	A reference to the output buffer of the current thread. NULL if it isn't redirected.
+ */
+std::streambuf*& thread_output();
+}
+
+template<typename F>
+std::future<std::invoke_result_t<F>> aoc::thread_pool::submit(F &&func) {
+	// std::function requires copyable functions, but packaged tasks can only be moved.
+	std::shared_ptr<std::packaged_task<std::invoke_result_t<F>()>> task =
+			std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(
+					std::forward<F>(func));
+	std::future<std::invoke_result_t<F>> future = task->get_future();
+	push([task]() {
+		(*task)();
+	});
+	return future;
+}
+
+#endif /* THREADPOOL_H_ */